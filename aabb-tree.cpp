@@ -0,0 +1,221 @@
+#include <sbash64/game/aabb-tree.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace sbash64::game {
+static auto perimeter(Rectangle a) -> distance_type {
+  return 2 * (a.width + a.height);
+}
+
+static auto contains(Rectangle outer, Rectangle inner) -> bool {
+  return leftEdge(outer) <= leftEdge(inner) &&
+         topEdge(outer) <= topEdge(inner) &&
+         rightEdge(inner) <= rightEdge(outer) &&
+         bottomEdge(inner) <= bottomEdge(outer);
+}
+
+static auto fatten(Rectangle a, distance_type margin) -> Rectangle {
+  return {Point{leftEdge(a) - margin, topEdge(a) - margin},
+          a.width + 2 * margin, a.height + 2 * margin};
+}
+
+DynamicAabbTree::DynamicAabbTree(distance_type fatMargin)
+    : fatMargin{fatMargin} {}
+
+auto DynamicAabbTree::allocate() -> std::size_t {
+  if (freeList == nullNode) {
+    nodes.push_back({});
+    freeList = nodes.size() - 1;
+    nodes[freeList].parent = nullNode;
+  }
+  const auto index{freeList};
+  freeList = nodes[index].parent;
+  nodes[index] = {{}, nullNode, nullNode, nullNode, 0, 0};
+  return index;
+}
+
+void DynamicAabbTree::release(std::size_t index) {
+  nodes[index].parent = freeList;
+  nodes[index].height = -1;
+  freeList = index;
+}
+
+auto DynamicAabbTree::insert(Rectangle rectangle, std::size_t userData)
+    -> std::size_t {
+  const auto leaf{allocate()};
+  nodes[leaf].rectangle = fatten(rectangle, fatMargin);
+  nodes[leaf].userData = userData;
+  insertLeaf(leaf);
+  ++leaves;
+  return leaf;
+}
+
+void DynamicAabbTree::remove(std::size_t proxy) {
+  removeLeaf(proxy);
+  release(proxy);
+  --leaves;
+}
+
+auto DynamicAabbTree::move(std::size_t proxy, Rectangle rectangle) -> bool {
+  if (contains(nodes[proxy].rectangle, rectangle))
+    return false;
+  removeLeaf(proxy);
+  nodes[proxy].rectangle = fatten(rectangle, fatMargin);
+  insertLeaf(proxy);
+  return true;
+}
+
+auto DynamicAabbTree::fatRectangle(std::size_t proxy) const -> Rectangle {
+  return nodes[proxy].rectangle;
+}
+
+auto DynamicAabbTree::userData(std::size_t proxy) const -> std::size_t {
+  return nodes[proxy].userData;
+}
+
+void DynamicAabbTree::setUserData(std::size_t proxy, std::size_t userData) {
+  nodes[proxy].userData = userData;
+}
+
+auto DynamicAabbTree::height() const -> int {
+  return root == nullNode ? 0 : nodes[root].height;
+}
+
+auto DynamicAabbTree::leafCount() const -> std::size_t { return leaves; }
+
+void DynamicAabbTree::candidatePairs(std::vector<CandidatePair> &pairs) {
+  for (std::size_t leaf{0}; leaf < nodes.size(); ++leaf)
+    if (nodes[leaf].height == 0)
+      query(nodes[leaf].rectangle, [&](std::size_t other) {
+        if (leaf < other)
+          pairs.emplace_back(
+              std::minmax(nodes[leaf].userData, nodes[other].userData));
+      });
+}
+
+void DynamicAabbTree::refit(std::size_t index) {
+  auto &node{nodes[index]};
+  node.rectangle =
+      unite(nodes[node.first].rectangle, nodes[node.second].rectangle);
+  node.height =
+      1 + std::max(nodes[node.first].height, nodes[node.second].height);
+}
+
+void DynamicAabbTree::insertLeaf(std::size_t leaf) {
+  if (root == nullNode) {
+    root = leaf;
+    nodes[root].parent = nullNode;
+    return;
+  }
+  const auto leafRectangle{nodes[leaf].rectangle};
+  auto sibling{root};
+  while (!nodes[sibling].leaf()) {
+    const auto &node{nodes[sibling]};
+    const auto combined{perimeter(unite(node.rectangle, leafRectangle))};
+    const auto cost{2 * combined};
+    const auto inheritance{2 * (combined - perimeter(node.rectangle))};
+    const auto descendCost{[&](std::size_t child) {
+      const auto &childNode{nodes[child]};
+      const auto enlarged{perimeter(unite(childNode.rectangle, leafRectangle))};
+      return (childNode.leaf() ? enlarged
+                               : enlarged - perimeter(childNode.rectangle)) +
+             inheritance;
+    }};
+    const auto firstCost{descendCost(node.first)};
+    const auto secondCost{descendCost(node.second)};
+    if (cost < firstCost && cost < secondCost)
+      break;
+    sibling = firstCost < secondCost ? node.first : node.second;
+  }
+
+  const auto oldParent{nodes[sibling].parent};
+  const auto newParent{allocate()};
+  nodes[newParent].parent = oldParent;
+  nodes[newParent].first = sibling;
+  nodes[newParent].second = leaf;
+  nodes[sibling].parent = newParent;
+  nodes[leaf].parent = newParent;
+  if (oldParent == nullNode)
+    root = newParent;
+  else if (nodes[oldParent].first == sibling)
+    nodes[oldParent].first = newParent;
+  else
+    nodes[oldParent].second = newParent;
+
+  for (auto index{newParent}; index != nullNode; index = nodes[index].parent) {
+    refit(index);
+    index = balance(index);
+  }
+}
+
+void DynamicAabbTree::removeLeaf(std::size_t leaf) {
+  if (leaf == root) {
+    root = nullNode;
+    return;
+  }
+  const auto parent{nodes[leaf].parent};
+  const auto grandparent{nodes[parent].parent};
+  const auto sibling{nodes[parent].first == leaf ? nodes[parent].second
+                                                 : nodes[parent].first};
+  release(parent);
+  nodes[sibling].parent = grandparent;
+  if (grandparent == nullNode) {
+    root = sibling;
+    return;
+  }
+  if (nodes[grandparent].first == parent)
+    nodes[grandparent].first = sibling;
+  else
+    nodes[grandparent].second = sibling;
+  for (auto index{grandparent}; index != nullNode;
+       index = nodes[index].parent) {
+    refit(index);
+    index = balance(index);
+  }
+}
+
+auto DynamicAabbTree::balance(std::size_t index) -> std::size_t {
+  const auto &node{nodes[index]};
+  if (node.leaf() || node.height < 2)
+    return index;
+  const auto difference{nodes[node.second].height - nodes[node.first].height};
+  if (difference > 1)
+    return rotate(index, node.second);
+  if (difference < -1)
+    return rotate(index, node.first);
+  return index;
+}
+
+// Promotes the taller child to take the place of its parent.
+auto DynamicAabbTree::rotate(std::size_t index, std::size_t child)
+    -> std::size_t {
+  const auto parent{nodes[index].parent};
+  const auto first{nodes[child].first};
+  const auto second{nodes[child].second};
+  const auto taller{nodes[first].height > nodes[second].height ? first
+                                                               : second};
+  const auto shorter{taller == first ? second : first};
+
+  nodes[child].parent = parent;
+  if (parent == nullNode)
+    root = child;
+  else if (nodes[parent].first == index)
+    nodes[parent].first = child;
+  else
+    nodes[parent].second = child;
+
+  if (nodes[index].first == child)
+    nodes[index].first = shorter;
+  else
+    nodes[index].second = shorter;
+  nodes[shorter].parent = index;
+  nodes[index].parent = child;
+  nodes[child].first = index;
+  nodes[child].second = taller;
+  refit(index);
+  refit(child);
+  return child;
+}
+} // namespace sbash64::game
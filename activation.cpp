@@ -0,0 +1,39 @@
+#include <sbash64/game/activation.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <ostream>
+
+namespace sbash64::game {
+auto updateActivation(GameWorld &world, Rectangle region) -> ActivationCounts {
+  ActivationCounts counts{};
+  world.each<Rectangle, Activation>(
+      [&](const Rectangle &rectangle, Activation &activation) {
+        activation.awake = overlaps(rectangle, region);
+        ++(activation.awake ? counts.active : counts.sleeping);
+      });
+  return counts;
+}
+
+void record(ActivationStats &stats, ActivationCounts counts) {
+  stats.latest = counts;
+  stats.maximum.active = std::max(stats.maximum.active, counts.active);
+  stats.maximum.sleeping = std::max(stats.maximum.sleeping, counts.sleeping);
+  stats.total.active += counts.active;
+  stats.total.sleeping += counts.sleeping;
+  ++stats.frames;
+}
+
+static auto mean(std::size_t total, std::size_t frames) -> std::size_t {
+  return frames == 0 ? 0 : total / frames;
+}
+
+void dump(std::ostream &stream, const ActivationStats &stats) {
+  stream << "active entities (latest/mean/max): " << stats.latest.active
+         << '/' << mean(stats.total.active, stats.frames) << '/'
+         << stats.maximum.active << '\n'
+         << "sleeping entities (latest/mean/max): " << stats.latest.sleeping
+         << '/' << mean(stats.total.sleeping, stats.frames) << '/'
+         << stats.maximum.sleeping << '\n';
+}
+} // namespace sbash64::game
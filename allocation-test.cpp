@@ -0,0 +1,233 @@
+#include <sbash64/game/activation.hpp>
+#include <sbash64/game/baked-level.hpp>
+#include <sbash64/game/behaviours.hpp>
+#include <sbash64/game/components.hpp>
+#include <sbash64/game/contact-cache.hpp>
+#include <sbash64/game/culling-index.hpp>
+#include <sbash64/game/game.hpp>
+#include <sbash64/game/moving-collisions.hpp>
+#include <sbash64/game/particles.hpp>
+#include <sbash64/game/render-snapshot.hpp>
+#include <sbash64/game/tile-layer.hpp>
+#include <sbash64/game/trigger-zones.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <vector>
+
+// Every allocation in the program, counted so that steady-state ticks can be
+// checked to allocate nothing.
+static std::atomic<std::uint64_t> allocations{0};
+
+auto operator new(std::size_t size) -> void * {
+  ++allocations;
+  if (auto *memory{std::malloc(size == 0 ? 1 : size)})
+    return memory;
+  throw std::bad_alloc{};
+}
+
+auto operator new[](std::size_t size) -> void * { return operator new(size); }
+
+void operator delete(void *memory) noexcept { std::free(memory); }
+
+void operator delete[](void *memory) noexcept { std::free(memory); }
+
+void operator delete(void *memory, std::size_t) noexcept {
+  std::free(memory);
+}
+
+void operator delete[](void *memory, std::size_t) noexcept {
+  std::free(memory);
+}
+
+namespace sbash64::game {
+constexpr distance_type floorTop{208};
+constexpr std::array builtInSolids{
+    Rectangle{Point{256, 144}, 15, 15},
+    Rectangle{Point{448, floorTop - 40}, 30, 40}};
+constexpr auto bakedSolids{bakeSolids(builtInSolids)};
+constexpr auto warmUpTicks{600};
+constexpr auto steadyTicks{6000};
+
+static auto solidsNear(MovingObject object) -> RectangleColumnsView {
+  const auto swept{unite(object.rectangle, applyVelocity(object).rectangle)};
+  return bakedSolids.near({Point{leftEdge(swept) - 1, topEdge(swept) - 1},
+                           swept.width + 2, swept.height + 2});
+}
+
+// The built-in solids sorted once for the handleSorted overloads.
+struct SortedSolids {
+  std::array<Rectangle, builtInSolids.size()> byTopEdge{builtInSolids};
+  std::array<Rectangle, builtInSolids.size()> byBottomEdge{builtInSolids};
+  std::array<Rectangle, builtInSolids.size()> byLeftEdge{builtInSolids};
+  std::array<Rectangle, builtInSolids.size()> byRightEdge{builtInSolids};
+
+  SortedSolids() {
+    sortByTopEdge(byTopEdge);
+    sortByBottomEdge(byBottomEdge);
+    sortByLeftEdge(byLeftEdge);
+    sortByRightEdge(byRightEdge);
+  }
+};
+
+// Steps the same systems as the game's simulation loop, with a player
+// running back and forth and jumping and guards patrolling, and fails if
+// any tick after warming up allocates.
+static auto run() -> int {
+  const Rectangle floorRectangle{Point{0, floorTop}, 1024, 32};
+  const Rectangle levelRectangle{Point{-1, -1}, 1025, 241};
+  const Rectangle camera{Point{0, 0}, 256, 240};
+  const RationalDistance gravity{1, 4};
+  constexpr std::array<BehaviourKind, 1> behaviourKinds{{{1024, 128}}};
+  Behaviours behaviours{behaviourKinds};
+  GameWorld world;
+  world.archetype<PlayerArchetype>().create(
+      Rectangle{Point{0, floorTop - 16}, 16, 16}, Velocity{{0, 1}, 0},
+      JumpState::grounded, DirectionFacing::right, Sprite{},
+      KeyboardControlled{}, MovingCollider{}, ContactCache{}, Activation{},
+      Animated{});
+  for (const distance_type left : {140, 300, 600})
+    world.archetype<EnemyArchetype>().create(
+        Rectangle{Point{left, floorTop - 16}, 16, 16}, Velocity{{0, 1}, 0},
+        DirectionFacing::right, Sprite{},
+        Scripted{behaviours.start(0, guard, left, left + 80)},
+        MovingCollider{}, ContactCache{}, Activation{}, Animated{});
+  MovingCollisionSystem movingCollisionSystem{4};
+  MovingCollisionStats movingCollisionStats{};
+  TileLayer tiles{Point{0, 0}, 16, 64, 15};
+  tiles.fill(floorRectangle);
+  ContactCacheCounts contactCacheCounts{};
+  ActivationStats activationStats{};
+  CullingIndex cullingIndex;
+  CullingStats cullingStats{};
+  ParticlePool particles{131072};
+  const TriggerZones triggerZones{
+      {{Rectangle{Point{200, 0}, 8, 240}, TriggerKind::checkpoint, 0}}};
+  TriggerOccupancy playerTriggers;
+  TriggerStats triggerStats{};
+  std::vector<TriggerEvent> triggerEvents;
+  RenderSnapshot snapshot;
+  const SortedSolids sortedSolids;
+  PlayerState crate{{Rectangle{Point{250, 0}, 8, 8}, Velocity{{0, 1}, 0}},
+                    JumpState::started, DirectionFacing::right};
+  const auto tick{[&](int t) {
+    const PlayerInput input{t % 400 >= 200, t % 400 < 200, t % 60 == 0};
+    record(activationStats,
+           updateActivation(world, {Point{-100, -100}, 1200, 440}));
+    world.each<Rectangle, Velocity, JumpState, DirectionFacing, ContactCache,
+               Activation, KeyboardControlled>(
+        [&](Rectangle &rectangle, Velocity &velocity, JumpState &jumpState,
+            DirectionFacing &directionFacing, ContactCache &contactCache,
+            const Activation &, const KeyboardControlled &) {
+          const auto wasGrounded{jumpState == JumpState::grounded};
+          const auto forced{applyVerticalForces(
+              applyHorizontalForces(playerState(rectangle, velocity,
+                                                jumpState, directionFacing),
+                                    input, 1, 4, 1),
+              input, -6, gravity)};
+          const auto solids{solidsNear(forced.object)};
+          store(handleVerticalCollisions(forced, contactCache,
+                                         contactCacheCounts, 0, tiles, solids,
+                                         solids, floorRectangle),
+                rectangle, velocity, jumpState, directionFacing);
+          if (!wasGrounded && jumpState == JumpState::grounded)
+            for (auto i{0}; i < 12; ++i)
+              particles.spawn(Point{rectangle.origin.x + i,
+                                    bottomEdge(rectangle)},
+                              RationalDistance{i - 6, 4},
+                              RationalDistance{-1 - i % 3, 2}, 20 + i % 4, 0);
+        });
+    world.each<Rectangle, Velocity, ContactCache, Activation>(
+        [&](Rectangle &rectangle, Velocity &velocity,
+            ContactCache &contactCache, const Activation &) {
+          const auto solids{solidsNear({rectangle, velocity})};
+          store(handleHorizontalCollisions(
+                    {rectangle, velocity}, contactCache, contactCacheCounts,
+                    0, tiles, solids, solids, levelRectangle),
+                rectangle, velocity);
+        });
+    Rectangle playerRectangle{};
+    world.each<Rectangle, KeyboardControlled>(
+        [&](const Rectangle &rectangle, const KeyboardControlled &) {
+          playerRectangle = rectangle;
+        });
+    world.each<Rectangle, Activation, Scripted>(
+        [&](const Rectangle &rectangle, const Activation &activation,
+            const Scripted &scripted) {
+          auto &view{behaviours.view(scripted.behaviour)};
+          view.self = rectangle;
+          view.player = playerRectangle;
+          view.awake = activation.awake;
+        });
+    behaviours.tick();
+    world.each<Rectangle, Velocity, DirectionFacing, ContactCache, Activation,
+               Scripted>([&](Rectangle &rectangle, Velocity &velocity,
+                             DirectionFacing &directionFacing,
+                             ContactCache &contactCache, const Activation &,
+                             const Scripted &scripted) {
+      auto &view{behaviours.view(scripted.behaviour)};
+      auto state{playerState(rectangle, velocity, view.jumpState,
+                             directionFacing)};
+      state.object.velocity.horizontal = view.horizontalVelocity;
+      state.object.velocity.vertical += gravity;
+      const auto solids{solidsNear(state.object)};
+      state = handleVerticalCollisions(state, contactCache, contactCacheCounts,
+                                       0, tiles, solids, solids,
+                                       floorRectangle);
+      const auto nearSolids{solidsNear(state.object)};
+      state.object = handleHorizontalCollisions(
+          state.object, contactCache, contactCacheCounts, 0, tiles, nearSolids,
+          nearSolids, levelRectangle);
+      view.jumpState = state.jumpState;
+      store(state.object, rectangle, velocity);
+    });
+    record(movingCollisionStats, movingCollisionSystem.update(world));
+    world.each<Rectangle, Velocity, Activation>(
+        [](Rectangle &rectangle, Velocity &velocity, const Activation &) {
+          store(applyVelocity({rectangle, velocity}), rectangle, velocity);
+        });
+    crate.object.velocity.vertical += gravity;
+    crate = handleSortedVerticalCollisions(crate, sortedSolids.byTopEdge,
+                                           sortedSolids.byBottomEdge,
+                                           floorRectangle);
+    crate.object = handleSortedHorizontalCollisions(
+        crate.object, sortedSolids.byLeftEdge, sortedSolids.byRightEdge,
+        levelRectangle);
+    crate.object = applyVelocity(crate.object);
+    triggerEvents.clear();
+    updateOccupancy(triggerZones, playerTriggers, playerRectangle,
+                    triggerEvents, triggerStats);
+    particles.update(gravity, floorTop);
+    snapshot.sprites.clear();
+    cullingIndex.sync(world);
+    record(cullingStats,
+           cullingIndex.visible(world, camera, [&](const Drawable &drawable) {
+             snapshot.sprites.push_back(
+                 {narrow(drawable.sprite.source),
+                  relativeTo(drawable.rectangle, camera.origin),
+                  drawable.sprite.sheet, false});
+           }));
+    snapshot.particles.resize(2);
+    for (auto &byColor : snapshot.particles)
+      byColor.clear();
+    particles.collect(camera, snapshot.particles);
+  }};
+  for (auto t{0}; t < warmUpTicks; ++t)
+    tick(t);
+  const auto warmUpAllocations{allocations.load()};
+  for (auto t{warmUpTicks}; t < warmUpTicks + steadyTicks; ++t)
+    tick(t);
+  const auto steadyAllocations{allocations.load() - warmUpAllocations};
+  std::cout << warmUpAllocations << " allocations in " << warmUpTicks
+            << " warm-up ticks, " << steadyAllocations << " in "
+            << steadyTicks << " steady-state ticks\n";
+  return steadyAllocations == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+} // namespace sbash64::game
+
+int main() { return sbash64::game::run(); }
@@ -0,0 +1,197 @@
+#include <sbash64/game/alsa-audio-sink.hpp>
+
+#include <alsa/asoundlib.h>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+
+namespace sbash64::game {
+static void throwAlsaRuntimeErrorOnFailure(const std::function<int()> &f,
+                                           std::string_view message) {
+  if (const auto error{f()}; error < 0)
+    throwAlsaRuntimeError(message, error);
+}
+
+// The period size asked for is only a hint, since many devices and dmix
+// accept only some sizes; the granted one is read back afterwards.
+static auto initializeAlsaPcm(snd_pcm_uframes_t periodSize,
+                              unsigned int sampleRate, bool dump)
+    -> alsa_wrappers::PCM {
+  alsa_wrappers::PCM pcm;
+  snd_pcm_hw_params_t *hw_params = nullptr;
+  throwAlsaRuntimeErrorOnFailure(
+      [&hw_params]() { return snd_pcm_hw_params_malloc(&hw_params); },
+      "cannot allocate hardware parameter structure");
+  const std::unique_ptr<snd_pcm_hw_params_t, void (*)(snd_pcm_hw_params_t *)>
+      hwParamsOwner{hw_params, snd_pcm_hw_params_free};
+  throwAlsaRuntimeErrorOnFailure(
+      [&pcm, hw_params]() { return snd_pcm_hw_params_any(pcm.pcm, hw_params); },
+      "cannot initialize hardware parameter structure");
+  throwAlsaRuntimeErrorOnFailure(
+      [&pcm, hw_params]() {
+        return snd_pcm_hw_params_set_access(pcm.pcm, hw_params,
+                                            SND_PCM_ACCESS_RW_INTERLEAVED);
+      },
+      "cannot set access type");
+  throwAlsaRuntimeErrorOnFailure(
+      [&pcm, hw_params]() {
+        return snd_pcm_hw_params_set_format(pcm.pcm, hw_params,
+                                            SND_PCM_FORMAT_S16);
+      },
+      "cannot set sample format");
+  throwAlsaRuntimeErrorOnFailure(
+      [&pcm, hw_params, sampleRate]() {
+        auto desiredSampleRate{sampleRate};
+        auto direction{0};
+        return snd_pcm_hw_params_set_rate_near(pcm.pcm, hw_params,
+                                               &desiredSampleRate, &direction);
+      },
+      "cannot set sample rate");
+  throwAlsaRuntimeErrorOnFailure(
+      [&pcm, hw_params, &periodSize]() {
+        auto direction{0};
+        return snd_pcm_hw_params_set_period_size_near(pcm.pcm, hw_params,
+                                                      &periodSize, &direction);
+      },
+      "cannot set period size");
+  unsigned int periods{2};
+  throwAlsaRuntimeErrorOnFailure(
+      [&pcm, hw_params, &periods]() {
+        auto direction{0};
+        return snd_pcm_hw_params_set_periods_near(pcm.pcm, hw_params, &periods,
+                                                  &direction);
+      },
+      "cannot set periods");
+  snd_pcm_uframes_t bufferSize{periods * periodSize};
+  throwAlsaRuntimeErrorOnFailure(
+      [&pcm, hw_params, &bufferSize]() {
+        return snd_pcm_hw_params_set_buffer_size_near(pcm.pcm, hw_params,
+                                                      &bufferSize);
+      },
+      "cannot set buffer size");
+  throwAlsaRuntimeErrorOnFailure(
+      [&pcm, hw_params]() {
+        return snd_pcm_hw_params_set_channels(pcm.pcm, hw_params, 2);
+      },
+      "cannot set channel count");
+  throwAlsaRuntimeErrorOnFailure(
+      [&pcm, hw_params]() { return snd_pcm_hw_params(pcm.pcm, hw_params); },
+      "cannot set parameters");
+  throwAlsaRuntimeErrorOnFailure(
+      [&pcm, &bufferSize, &periodSize]() {
+        return snd_pcm_get_params(pcm.pcm, &bufferSize, &periodSize);
+      },
+      "cannot get parameters");
+
+  snd_pcm_sw_params_t *sw_params = nullptr;
+  throwAlsaRuntimeErrorOnFailure(
+      [&sw_params]() { return snd_pcm_sw_params_malloc(&sw_params); },
+      "cannot allocate software parameters structure");
+  const std::unique_ptr<snd_pcm_sw_params_t, void (*)(snd_pcm_sw_params_t *)>
+      swParamsOwner{sw_params, snd_pcm_sw_params_free};
+  throwAlsaRuntimeErrorOnFailure(
+      [&pcm, sw_params]() {
+        return snd_pcm_sw_params_current(pcm.pcm, sw_params);
+      },
+      "cannot initialize software parameters structure");
+  throwAlsaRuntimeErrorOnFailure(
+      [&pcm, sw_params, periodSize]() {
+        return snd_pcm_sw_params_set_avail_min(pcm.pcm, sw_params, periodSize);
+      },
+      "cannot set minimum available count");
+  throwAlsaRuntimeErrorOnFailure(
+      [&pcm, sw_params, bufferSize, periodSize]() {
+        return snd_pcm_sw_params_set_start_threshold(
+            pcm.pcm, sw_params, (bufferSize / periodSize) * periodSize);
+      },
+      "cannot set start threshold");
+  throwAlsaRuntimeErrorOnFailure(
+      [&pcm, sw_params]() { return snd_pcm_sw_params(pcm.pcm, sw_params); },
+      "cannot set software parameters");
+
+  if (!dump)
+    return pcm;
+  snd_output_t *debugOutput{};
+  throwAlsaRuntimeErrorOnFailure(
+      [&debugOutput]() {
+        return snd_output_stdio_attach(&debugOutput, stdout, 0);
+      },
+      "cannot initialize stdio output");
+  snd_pcm_dump(pcm.pcm, debugOutput);
+  snd_output_close(debugOutput);
+
+  return pcm;
+}
+
+// Returns the period size in effect.
+static auto recordAlsaConfiguration(AudioStats &stats,
+                                    const alsa_wrappers::PCM &pcm,
+                                    unsigned int sampleRate) -> std::int64_t {
+  snd_pcm_uframes_t bufferFrames{};
+  snd_pcm_uframes_t periodFrames{};
+  throwAlsaRuntimeErrorOnFailure(
+      [&pcm, &bufferFrames, &periodFrames]() {
+        return snd_pcm_get_params(pcm.pcm, &bufferFrames, &periodFrames);
+      },
+      "cannot get parameters");
+  recordConfiguration(stats, static_cast<std::int64_t>(periodFrames),
+                      static_cast<std::int64_t>(bufferFrames), sampleRate);
+  return static_cast<std::int64_t>(periodFrames);
+}
+
+AlsaAudioSink::AlsaAudioSink(AudioStats &stats, unsigned int sampleRate,
+                             std::int64_t periodFrames)
+    : stats{stats}, sampleRate{sampleRate} {
+  open(periodFrames, true);
+}
+
+// Renegotiating happens on the audio thread, so a size the device refuses
+// falls back to the last one that worked instead of escaping.
+void AlsaAudioSink::configure(std::int64_t periodFrames) {
+  const auto workingPeriodFrames{grantedPeriodFrames};
+  try {
+    open(periodFrames, false);
+  } catch (const std::runtime_error &) {
+    open(workingPeriodFrames, false);
+  }
+}
+
+auto AlsaAudioSink::periodFrames() const -> std::int64_t {
+  return grantedPeriodFrames;
+}
+
+void AlsaAudioSink::open(std::int64_t periodFrames, bool dump) {
+  pcm.reset();
+  pcm.emplace(initializeAlsaPcm(static_cast<snd_pcm_uframes_t>(periodFrames),
+                                sampleRate, dump));
+  grantedPeriodFrames = recordAlsaConfiguration(stats, *pcm, sampleRate);
+}
+
+void AlsaAudioSink::waitForPeriod() {
+  throwAlsaRuntimeErrorOnFailure(
+      [this]() { return snd_pcm_wait(pcm->pcm, -1); }, "wait failed");
+  snd_pcm_sframes_t availFrames{};
+  snd_pcm_sframes_t delayFrames{};
+  if (snd_pcm_avail_delay(pcm->pcm, &availFrames, &delayFrames) == 0)
+    recordBufferLevel(stats, availFrames, delayFrames);
+}
+
+auto AlsaAudioSink::write(std::span<const short> interleavedPeriod) -> bool {
+  if (const auto framesWritten{snd_pcm_writei(
+          pcm->pcm, interleavedPeriod.data(),
+          interleavedPeriod.size() / audioChannels)};
+      framesWritten < 0) {
+    throwAlsaRuntimeErrorOnFailure(
+        [this, framesWritten]() {
+          return snd_pcm_recover(pcm->pcm, static_cast<int>(framesWritten), 0);
+        },
+        "recover failed");
+    return false;
+  }
+  return true;
+}
+} // namespace sbash64::game
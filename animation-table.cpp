@@ -0,0 +1,119 @@
+#include <sbash64/game/animation-table.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace sbash64::game {
+constexpr std::array<char, 4> magic{'S', 'B', 'A', 'T'};
+constexpr std::uint16_t version{1};
+
+static void writeU16(std::ostream &stream, std::size_t value) {
+  if (value > std::numeric_limits<std::uint16_t>::max())
+    throw std::runtime_error{"animation table field out of range"};
+  stream.put(static_cast<char>(value & 0xFFU));
+  stream.put(static_cast<char>(value >> 8U));
+}
+
+static void writeU16(std::ostream &stream, distance_type value) {
+  if (isNegative(value))
+    throw std::runtime_error{"animation table field out of range"};
+  writeU16(stream, static_cast<std::size_t>(value));
+}
+
+static auto readU16(std::istream &stream) -> std::uint16_t {
+  std::array<char, 2> bytes{};
+  if (!stream.read(bytes.data(), bytes.size()))
+    throw std::runtime_error{"truncated animation table"};
+  return static_cast<std::uint16_t>(
+      static_cast<unsigned char>(bytes[0]) |
+      static_cast<unsigned>(static_cast<unsigned char>(bytes[1])) << 8U);
+}
+
+void writeAnimationTable(std::ostream &stream,
+                         std::span<const AnimationDefinition> animations,
+                         std::size_t atlases) {
+  stream.write(magic.data(), magic.size());
+  writeU16(stream, std::size_t{version});
+  writeU16(stream, atlases);
+  writeU16(stream, animations.size());
+  for (const auto &animation : animations) {
+    if (animation.name.size() > std::numeric_limits<std::uint8_t>::max())
+      throw std::runtime_error{"animation name too long: " + animation.name};
+    if (animation.frames.empty())
+      throw std::runtime_error{"animation without frames: " +
+                               animation.name};
+    stream.put(static_cast<char>(animation.name.size()));
+    stream.write(animation.name.data(),
+                 static_cast<std::streamsize>(animation.name.size()));
+    writeU16(stream, animation.frames.size());
+    for (const auto &frame : animation.frames) {
+      if (frame.ticks == 0)
+        throw std::runtime_error{"animation frame without ticks: " +
+                                 animation.name};
+      writeU16(stream, frame.sprite.sheet);
+      writeU16(stream, frame.sprite.source.origin.x);
+      writeU16(stream, frame.sprite.source.origin.y);
+      writeU16(stream, frame.sprite.source.width);
+      writeU16(stream, frame.sprite.source.height);
+      writeU16(stream, std::size_t{frame.ticks});
+    }
+  }
+}
+
+AnimationTable::AnimationTable(std::istream &stream) {
+  std::array<char, magic.size()> header{};
+  if (!stream.read(header.data(), header.size()) || header != magic)
+    throw std::runtime_error{"not an animation table"};
+  if (readU16(stream) != version)
+    throw std::runtime_error{"unsupported animation table version"};
+  atlasCount = readU16(stream);
+  const auto animations{readU16(stream)};
+  for (std::uint16_t animation{0}; animation < animations; ++animation) {
+    const auto nameLength{stream.get()};
+    std::string name(static_cast<std::size_t>(std::max(nameLength, 0)), '\0');
+    if (nameLength == std::istream::traits_type::eof() ||
+        !stream.read(name.data(), static_cast<std::streamsize>(name.size())))
+      throw std::runtime_error{"truncated animation table"};
+    const auto frameCount{readU16(stream)};
+    if (frameCount == 0)
+      throw std::runtime_error{"animation without frames: " + name};
+    const auto firstTick{frameOfTick.size()};
+    for (std::uint16_t frame{0}; frame < frameCount; ++frame) {
+      Sprite sprite{};
+      sprite.sheet = readU16(stream);
+      sprite.source.origin.x = readU16(stream);
+      sprite.source.origin.y = readU16(stream);
+      sprite.source.width = readU16(stream);
+      sprite.source.height = readU16(stream);
+      const auto ticks{readU16(stream)};
+      if (sprite.sheet >= atlasCount || ticks == 0)
+        throw std::runtime_error{"invalid frame in animation " + name};
+      frameOfTick.insert(frameOfTick.end(), ticks,
+                         static_cast<std::uint32_t>(frames.size()));
+      frames.push_back(sprite);
+    }
+    names.push_back(std::move(name));
+    loops.push_back({firstTick, frameOfTick.size() - firstTick});
+  }
+}
+
+auto AnimationTable::find(std::string_view name) const -> std::uint32_t {
+  const auto found{std::find(names.begin(), names.end(), name)};
+  if (found == names.end())
+    throw std::runtime_error{"no animation named " + std::string{name}};
+  return static_cast<std::uint32_t>(found - names.begin());
+}
+
+auto AnimationTable::atlases() const -> std::size_t { return atlasCount; }
+} // namespace sbash64::game
@@ -0,0 +1,96 @@
+#include <sbash64/game/atlas-packer.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <numeric>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace sbash64::game {
+SkylinePacker::SkylinePacker(distance_type width, distance_type height)
+    : skyline{{0, 0, width}}, width{width}, height{height} {}
+
+auto SkylinePacker::restingTop(std::size_t first, distance_type width,
+                               distance_type height) const
+    -> std::optional<distance_type> {
+  const auto right{skyline[first].x + width};
+  if (right > this->width)
+    return std::nullopt;
+  distance_type top{0};
+  for (auto i{first}; i < skyline.size() && skyline[i].x < right; ++i)
+    top = std::max(top, skyline[i].y);
+  if (top + height > this->height)
+    return std::nullopt;
+  return top;
+}
+
+auto SkylinePacker::insert(distance_type width, distance_type height)
+    -> std::optional<Point> {
+  std::optional<std::size_t> best;
+  distance_type bestTop{0};
+  for (std::size_t i{0}; i < skyline.size(); ++i)
+    if (const auto top{restingTop(i, width, height)};
+        top && (!best || *top < bestTop)) {
+      best = i;
+      bestTop = *top;
+    }
+  if (!best)
+    return std::nullopt;
+  const Point origin{skyline[*best].x, bestTop};
+  const auto right{origin.x + width};
+  auto last{*best};
+  while (last < skyline.size() &&
+         skyline[last].x + skyline[last].width <= right)
+    ++last;
+  if (last < skyline.size() && skyline[last].x < right) {
+    skyline[last].width -= right - skyline[last].x;
+    skyline[last].x = right;
+  }
+  skyline.erase(skyline.begin() + static_cast<std::ptrdiff_t>(*best),
+                skyline.begin() + static_cast<std::ptrdiff_t>(last));
+  skyline.insert(skyline.begin() + static_cast<std::ptrdiff_t>(*best),
+                 Segment{origin.x, origin.y + height, width});
+  for (std::size_t i{1}; i < skyline.size();)
+    if (skyline[i - 1].y == skyline[i].y) {
+      skyline[i - 1].width += skyline[i].width;
+      skyline.erase(skyline.begin() + static_cast<std::ptrdiff_t>(i));
+    } else
+      ++i;
+  return origin;
+}
+
+auto packAtlases(std::span<const Rectangle> sizes, distance_type atlasWidth,
+                 distance_type atlasHeight, distance_type padding)
+    -> std::vector<AtlasPlacement> {
+  std::vector<std::size_t> order(sizes.size());
+  std::iota(order.begin(), order.end(), std::size_t{0});
+  std::stable_sort(order.begin(), order.end(),
+                   [&sizes](std::size_t a, std::size_t b) {
+                     return sizes[a].height > sizes[b].height ||
+                            (sizes[a].height == sizes[b].height &&
+                             sizes[a].width > sizes[b].width);
+                   });
+  std::vector<SkylinePacker> atlases;
+  std::vector<AtlasPlacement> placements(sizes.size());
+  for (const auto i : order) {
+    const auto width{sizes[i].width + padding};
+    const auto height{sizes[i].height + padding};
+    auto placed{false};
+    for (std::size_t atlas{0}; atlas < atlases.size() && !placed; ++atlas)
+      if (const auto origin{atlases[atlas].insert(width, height)}) {
+        placements[i] = {atlas, *origin};
+        placed = true;
+      }
+    if (placed)
+      continue;
+    const auto origin{
+        atlases.emplace_back(atlasWidth, atlasHeight).insert(width, height)};
+    if (!origin)
+      throw std::runtime_error{"sprite frame larger than the atlas"};
+    placements[i] = {atlases.size() - 1, *origin};
+  }
+  return placements;
+}
+} // namespace sbash64::game
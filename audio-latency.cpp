@@ -0,0 +1,57 @@
+#include <sbash64/game/audio-latency.hpp>
+
+#include <algorithm>
+#include <cstdint>
+
+namespace sbash64::game {
+static auto withPeriodFrames(PeriodSizeTuner tuner, std::int64_t periodFrames)
+    -> PeriodSizeTuner {
+  tuner.periodFrames = periodFrames;
+  tuner.xruns = 0;
+  tuner.stableFrames = 0;
+  return tuner;
+}
+
+auto startTuning(const AudioLatencyTuning &tuning) -> PeriodSizeTuner {
+  return {tuning.minimumPeriodFrames, 0, 0, 0};
+}
+
+auto afterXrun(PeriodSizeTuner tuner, const AudioLatencyTuning &tuning)
+    -> PeriodSizeTuner {
+  tuner.stableFrames = 0;
+  if (!autoTuned(tuning) || ++tuner.xruns < tuning.xrunsBeforeGrowing ||
+      tuner.periodFrames >= tuning.maximumPeriodFrames)
+    return tuner;
+  tuner.largestUnstablePeriodFrames =
+      std::max(tuner.largestUnstablePeriodFrames, tuner.periodFrames);
+  return withPeriodFrames(
+      tuner, std::min(2 * tuner.periodFrames, tuning.maximumPeriodFrames));
+}
+
+auto afterPeriodWritten(PeriodSizeTuner tuner,
+                        const AudioLatencyTuning &tuning) -> PeriodSizeTuner {
+  if (!autoTuned(tuning))
+    return tuner;
+  tuner.stableFrames += tuner.periodFrames;
+  if (tuner.stableFrames < tuning.stableFramesBeforeShrinking)
+    return tuner;
+  tuner.xruns = 0;
+  const auto smallerPeriodFrames{
+      std::max(tuner.periodFrames / 2, tuning.minimumPeriodFrames)};
+  if (smallerPeriodFrames == tuner.periodFrames ||
+      smallerPeriodFrames <= tuner.largestUnstablePeriodFrames) {
+    tuner.stableFrames = 0;
+    return tuner;
+  }
+  return withPeriodFrames(tuner, smallerPeriodFrames);
+}
+
+auto afterConfigured(PeriodSizeTuner tuner, std::int64_t grantedPeriodFrames)
+    -> PeriodSizeTuner {
+  if (grantedPeriodFrames > tuner.periodFrames)
+    tuner.largestUnstablePeriodFrames =
+        std::max(tuner.largestUnstablePeriodFrames, tuner.periodFrames);
+  tuner.periodFrames = grantedPeriodFrames;
+  return tuner;
+}
+} // namespace sbash64::game
@@ -0,0 +1,43 @@
+#include <sbash64/game/audio-mixer.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace sbash64::game {
+void startJumpSound(AudioMixer &mixer) {
+  mixer.playingJumpSound = true;
+  mixer.jumpSoundDataOffset = 0;
+}
+
+void mix(AudioMixer &mixer, std::span<short> interleavedPeriod,
+         const std::vector<short> &backgroundMusicData,
+         const std::vector<short> &jumpSoundData) {
+  const auto periodSize{interleavedPeriod.size() / 2};
+  if (mixer.backgroundMusicDataOffset + interleavedPeriod.size() >
+      backgroundMusicData.size())
+    mixer.backgroundMusicDataOffset = 0;
+
+  std::copy(backgroundMusicData.begin() + mixer.backgroundMusicDataOffset,
+            backgroundMusicData.begin() + mixer.backgroundMusicDataOffset +
+                static_cast<std::ptrdiff_t>(interleavedPeriod.size()),
+            interleavedPeriod.begin());
+
+  if (mixer.playingJumpSound) {
+    if (mixer.jumpSoundDataOffset + periodSize > jumpSoundData.size()) {
+      mixer.playingJumpSound = false;
+    } else {
+      auto counter{0};
+      for (auto &x : interleavedPeriod)
+        x += jumpSoundData[mixer.jumpSoundDataOffset + counter++ / 2];
+    }
+  }
+}
+
+void advance(AudioMixer &mixer, std::ptrdiff_t periodFrames) {
+  mixer.backgroundMusicDataOffset += 2 * periodFrames;
+  if (mixer.playingJumpSound)
+    mixer.jumpSoundDataOffset += periodFrames;
+}
+} // namespace sbash64::game
@@ -0,0 +1,38 @@
+#include <sbash64/game/audio-sink.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <span>
+#include <thread>
+
+namespace sbash64::game {
+void PeriodPacer::configure(std::int64_t periodFrames,
+                            unsigned int sampleRate) {
+  periodDuration = std::chrono::nanoseconds{
+      periodFrames * std::chrono::nanoseconds::period::den / sampleRate};
+}
+
+void PeriodPacer::wait() {
+  std::this_thread::sleep_until(nextPeriod);
+  nextPeriod += periodDuration;
+}
+
+NullAudioSink::NullAudioSink(AudioStats &stats, unsigned int sampleRate,
+                             std::int64_t periodFrames)
+    : stats{stats}, sampleRate{sampleRate} {
+  configure(periodFrames);
+}
+
+void NullAudioSink::configure(std::int64_t periodFrames) {
+  configuredPeriodFrames = periodFrames;
+  recordConfiguration(stats, periodFrames, 0, sampleRate);
+}
+
+auto NullAudioSink::periodFrames() const -> std::int64_t {
+  return configuredPeriodFrames;
+}
+
+void NullAudioSink::waitForPeriod() {}
+
+auto NullAudioSink::write(std::span<const short>) -> bool { return true; }
+} // namespace sbash64::game
@@ -0,0 +1,130 @@
+#include <sbash64/game/audio-stats.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <ostream>
+
+namespace sbash64::game {
+template <typename T> static void add(std::atomic<T> &total, T amount) {
+  total.store(total.load(std::memory_order_relaxed) + amount,
+              std::memory_order_relaxed);
+}
+
+static void increment(std::atomic<std::uint64_t> &count) {
+  add(count, std::uint64_t{1});
+}
+
+template <typename T> static void raiseTo(std::atomic<T> &maximum, T value) {
+  if (value > maximum.load(std::memory_order_relaxed))
+    maximum.store(value, std::memory_order_relaxed);
+}
+
+template <typename T> static void lowerTo(std::atomic<T> &minimum, T value) {
+  if (value < minimum.load(std::memory_order_relaxed))
+    minimum.store(value, std::memory_order_relaxed);
+}
+
+static auto toNanoseconds(std::int64_t frames, std::int64_t sampleRate)
+    -> std::int64_t {
+  return frames * std::chrono::nanoseconds::period::den / sampleRate;
+}
+
+void recordConfiguration(AudioStats &stats, std::int64_t periodFrames,
+                         std::int64_t bufferFrames, std::int64_t sampleRate) {
+  stats.periodFrames.store(periodFrames, std::memory_order_relaxed);
+  stats.bufferFrames.store(bufferFrames, std::memory_order_relaxed);
+  stats.latencyNanoseconds.store(toNanoseconds(bufferFrames, sampleRate),
+                                 std::memory_order_relaxed);
+  stats.periodBudgetNanoseconds.store(toNanoseconds(periodFrames, sampleRate),
+                                      std::memory_order_relaxed);
+  increment(stats.configurations);
+}
+
+void recordMix(AudioStats &stats, std::chrono::nanoseconds duration) {
+  const auto nanoseconds{static_cast<std::int64_t>(duration.count())};
+  stats.mixNanoseconds.store(nanoseconds, std::memory_order_relaxed);
+  raiseTo(stats.maximumMixNanoseconds, nanoseconds);
+  add(stats.totalMixNanoseconds, nanoseconds);
+  if (nanoseconds >
+      stats.periodBudgetNanoseconds.load(std::memory_order_relaxed))
+    increment(stats.mixesOverBudget);
+  increment(stats.mixes);
+}
+
+void recordWakeup(AudioStats &stats,
+                  std::chrono::nanoseconds sincePreviousWakeup) {
+  const auto jitter{std::abs(
+      static_cast<std::int64_t>(sincePreviousWakeup.count()) -
+      stats.periodBudgetNanoseconds.load(std::memory_order_relaxed))};
+  stats.wakeupJitterNanoseconds.store(jitter, std::memory_order_relaxed);
+  raiseTo(stats.maximumWakeupJitterNanoseconds, jitter);
+  add(stats.totalWakeupJitterNanoseconds, jitter);
+  increment(stats.wakeups);
+}
+
+void recordBufferLevel(AudioStats &stats, std::int64_t availFrames,
+                       std::int64_t delayFrames) {
+  stats.availFrames.store(availFrames, std::memory_order_relaxed);
+  lowerTo(stats.minimumAvailFrames, availFrames);
+  raiseTo(stats.maximumAvailFrames, availFrames);
+  add(stats.totalAvailFrames, availFrames);
+  stats.delayFrames.store(delayFrames, std::memory_order_relaxed);
+  lowerTo(stats.minimumDelayFrames, delayFrames);
+  raiseTo(stats.maximumDelayFrames, delayFrames);
+  add(stats.totalDelayFrames, delayFrames);
+  increment(stats.bufferLevelSamples);
+}
+
+void recordPeriodWritten(AudioStats &stats) {
+  increment(stats.periodsWritten);
+}
+
+void recordXrun(AudioStats &stats) { increment(stats.xruns); }
+
+static auto mean(const std::atomic<std::int64_t> &total,
+                 const std::atomic<std::uint64_t> &count) -> std::int64_t {
+  const auto n{count.load(std::memory_order_relaxed)};
+  return n == 0 ? 0
+                : total.load(std::memory_order_relaxed) /
+                      static_cast<std::int64_t>(n);
+}
+
+static auto microseconds(std::int64_t nanoseconds) -> std::int64_t {
+  return nanoseconds / 1000;
+}
+
+void dump(std::ostream &stream, const AudioStats &stats) {
+  const auto bufferLevelSamples{
+      stats.bufferLevelSamples.load(std::memory_order_relaxed)};
+  const auto configurations{
+      stats.configurations.load(std::memory_order_relaxed)};
+  stream << "audio period/buffer frames: " << stats.periodFrames << '/'
+         << stats.bufferFrames << '\n'
+         << "audio latency us: " << microseconds(stats.latencyNanoseconds)
+         << '\n'
+         << "audio renegotiations: "
+         << (configurations == 0 ? 0 : configurations - 1) << '\n'
+         << "audio periods written: " << stats.periodsWritten << '\n'
+         << "audio xruns: " << stats.xruns << '\n'
+         << "audio avail frames (min/mean/max): "
+         << (bufferLevelSamples == 0 ? 0 : stats.minimumAvailFrames.load())
+         << '/' << mean(stats.totalAvailFrames, stats.bufferLevelSamples)
+         << '/' << stats.maximumAvailFrames << '\n'
+         << "audio delay frames (min/mean/max): "
+         << (bufferLevelSamples == 0 ? 0 : stats.minimumDelayFrames.load())
+         << '/' << mean(stats.totalDelayFrames, stats.bufferLevelSamples)
+         << '/' << stats.maximumDelayFrames << '\n'
+         << "audio mix us (mean/max, budget): "
+         << microseconds(
+                mean(stats.totalMixNanoseconds, stats.mixes))
+         << '/' << microseconds(stats.maximumMixNanoseconds) << ", "
+         << microseconds(stats.periodBudgetNanoseconds) << '\n'
+         << "audio mixes over budget: " << stats.mixesOverBudget << '\n'
+         << "audio wakeup jitter us (mean/max): "
+         << microseconds(
+                mean(stats.totalWakeupJitterNanoseconds, stats.wakeups))
+         << '/' << microseconds(stats.maximumWakeupJitterNanoseconds) << '\n';
+}
+} // namespace sbash64::game
@@ -0,0 +1,88 @@
+#include <sbash64/game/batch-simulation.hpp>
+#include <sbash64/game/game.hpp>
+#include <sbash64/game/thread-pool.hpp>
+#include <sbash64/game/tile-layer.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+// Steps a batch of headless games with random inputs across a thread pool and
+// prints how many instance-ticks it manages per second.
+namespace sbash64::game {
+static auto level() -> SimulationLevel {
+  const Rectangle floor{Point{0, 208}, 1024, 32};
+  SimulationLevel level{TileLayer{Point{0, 0}, 16, 64, 15},
+                        {},
+                        floor,
+                        Rectangle{Point{-1, -1}, 1025, 241},
+                        Rectangle{Point{0, 192}, 16, 16},
+                        {Rectangle{Point{140, 192}, 16, 16},
+                         Rectangle{Point{600, 192}, 16, 16}}};
+  level.tiles.fill(floor);
+  level.solids.push_back({Point{256, 144}, 15, 15});
+  level.solids.push_back({Point{448, 168}, 30, 40});
+  return level;
+}
+
+static auto run(std::size_t threads, std::size_t instances,
+                std::uint64_t ticks) -> int {
+  const auto simulationLevel{level()};
+  BatchSimulation simulation{simulationLevel, {{1, 4}, 1, 4, -6, 2, 1},
+                             instances};
+  ThreadPool pool{threads};
+  std::vector<PlayerInput> inputs(instances);
+  std::vector<Observation> observations(instances);
+  std::mt19937_64 engine{44};
+  std::uniform_int_distribution<int> action{0, 7};
+  std::chrono::steady_clock::duration stepping{};
+  distance_type checksum{0};
+  for (std::uint64_t tick{0}; tick < ticks; ++tick) {
+    // Inputs are drawn outside the timed step, as a playtesting agent's
+    // would be.
+    for (auto &input : inputs) {
+      const auto next{action(engine)};
+      input = {next < 2, next >= 4, next % 4 == 0};
+    }
+    const auto start{std::chrono::steady_clock::now()};
+    simulation.step(inputs, observations, pool);
+    stepping += std::chrono::steady_clock::now() - start;
+    for (const auto &observation : observations)
+      checksum += observation.player.origin.x;
+  }
+  const auto seconds{std::chrono::duration<double>{stepping}.count()};
+  const auto counts{simulation.contactCacheCounts()};
+  std::cout << instances << " instances, " << pool.threads() << " threads, "
+            << ticks << " ticks: "
+            << static_cast<double>(instances * ticks) / seconds
+            << " instance-ticks/s\n"
+            << "contact cache: " << counts.hits << " hits, " << counts.misses
+            << " misses\n"
+            << "checksum " << checksum << '\n';
+  return EXIT_SUCCESS;
+}
+} // namespace sbash64::game
+
+int main(int argc, char *argv[]) {
+  std::span<char *> arguments{argv,
+                              static_cast<std::span<char *>::size_type>(argc)};
+  if (arguments.size() < 3) {
+    std::cerr << "usage: " << arguments[0]
+              << " <threads> <instances> [ticks]\n";
+    return EXIT_FAILURE;
+  }
+  try {
+    return sbash64::game::run(
+        std::stoul(arguments[1]), std::stoul(arguments[2]),
+        arguments.size() > 3 ? std::stoull(arguments[3]) : 600);
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << '\n';
+    return EXIT_FAILURE;
+  }
+}
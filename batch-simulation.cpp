@@ -0,0 +1,140 @@
+#include <sbash64/game/batch-simulation.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <stdexcept>
+
+namespace sbash64::game {
+constexpr std::size_t instancesPerChunk{64};
+constexpr std::size_t geometryVersion{0};
+
+static auto chunks(std::size_t instances) -> std::size_t {
+  return (instances + instancesPerChunk - 1) / instancesPerChunk;
+}
+
+static auto standing(Rectangle rectangle) -> PlayerState {
+  return {{rectangle, {{0, 1}, 0}}, JumpState::grounded,
+          DirectionFacing::right};
+}
+
+static auto towards(Rectangle from, Rectangle to, distance_type speed)
+    -> distance_type {
+  if (leftEdge(to) < leftEdge(from))
+    return -speed;
+  if (leftEdge(to) > leftEdge(from))
+    return speed;
+  return 0;
+}
+
+static auto overlap(Rectangle a, Rectangle b) -> bool {
+  return leftEdge(a) <= rightEdge(b) && leftEdge(b) <= rightEdge(a) &&
+         topEdge(a) <= bottomEdge(b) && topEdge(b) <= bottomEdge(a);
+}
+
+static auto manhattanDistance(Point a) -> distance_type {
+  return absoluteValue(a.x) + absoluteValue(a.y);
+}
+
+BatchSimulation::BatchSimulation(const SimulationLevel &level,
+                                 SimulationPhysics physics,
+                                 std::size_t instances)
+    : level{level}, physics{physics}, players(instances),
+      playerContacts(instances),
+      enemies(instances * level.enemyStarts.size()),
+      enemyContacts(enemies.size()), chunkCounts(chunks(instances)) {
+  for (std::size_t instance{0}; instance < instances; ++instance)
+    reset(instance);
+}
+
+void BatchSimulation::reset(std::size_t instance) {
+  players.at(instance) = standing(level.playerStart);
+  playerContacts[instance] = {};
+  const auto perInstance{level.enemyStarts.size()};
+  for (std::size_t i{0}; i < perInstance; ++i) {
+    enemies[instance * perInstance + i] = standing(level.enemyStarts[i]);
+    enemyContacts[instance * perInstance + i] = {};
+  }
+}
+
+void BatchSimulation::step(std::span<const PlayerInput> inputs,
+                           std::span<Observation> observations,
+                           ThreadPool &pool) {
+  if (inputs.size() != players.size() ||
+      observations.size() != players.size())
+    throw std::runtime_error{
+        "expected one input and observation per instance"};
+  pool.run(chunkCounts.size(), [&](std::size_t chunk) {
+    const auto first{chunk * instancesPerChunk};
+    const auto last{std::min(first + instancesPerChunk, players.size())};
+    // Counted locally so that threads do not write neighbouring counts.
+    ContactCacheCounts counts{};
+    for (auto instance{first}; instance < last; ++instance)
+      stepInstance(instance, inputs[instance], observations[instance],
+                   counts);
+    chunkCounts[chunk].hits += counts.hits;
+    chunkCounts[chunk].misses += counts.misses;
+  });
+  ++tickCount;
+}
+
+void BatchSimulation::stepInstance(std::size_t instance, PlayerInput input,
+                                   Observation &observation,
+                                   ContactCacheCounts &counts) {
+  auto &player{players[instance]};
+  player = handleVerticalCollisions(
+      applyVerticalForces(
+          applyHorizontalForces(player, input, physics.groundFriction,
+                                physics.playerMaxHorizontalSpeed,
+                                physics.playerRunAcceleration),
+          input, physics.playerJumpAcceleration, physics.gravity),
+      playerContacts[instance], counts, geometryVersion, level.tiles,
+      level.solids, level.solids, level.floor);
+  player.object = applyVelocity(handleHorizontalCollisions(
+      player.object, playerContacts[instance], counts, geometryVersion,
+      level.tiles, level.solids, level.solids, level.bounds));
+  const auto playerRectangle{player.object.rectangle};
+  observation = {playerRectangle, player.object.velocity, player.jumpState,
+                 Point{0, 0}, false};
+  const auto perInstance{level.enemyStarts.size()};
+  auto nearest{std::numeric_limits<distance_type>::max()};
+  for (auto i{instance * perInstance}; i < (instance + 1) * perInstance; ++i) {
+    auto &enemy{enemies[i]};
+    enemy.object.velocity.horizontal = towards(
+        enemy.object.rectangle, playerRectangle, physics.enemySpeed);
+    enemy.object.velocity.vertical += physics.gravity;
+    enemy = handleVerticalCollisions(enemy, enemyContacts[i], counts,
+                                     geometryVersion, level.tiles,
+                                     level.solids, level.solids, level.floor);
+    enemy.object = applyVelocity(handleHorizontalCollisions(
+        enemy.object, enemyContacts[i], counts, geometryVersion, level.tiles,
+        level.solids, level.solids, level.bounds));
+    const auto enemyRectangle{enemy.object.rectangle};
+    const Point offset{leftEdge(enemyRectangle) - leftEdge(playerRectangle),
+                       topEdge(enemyRectangle) - topEdge(playerRectangle)};
+    if (manhattanDistance(offset) < nearest) {
+      nearest = manhattanDistance(offset);
+      observation.nearestEnemy = offset;
+    }
+    observation.touchingEnemy = observation.touchingEnemy ||
+                                overlap(enemyRectangle, playerRectangle);
+  }
+}
+
+auto BatchSimulation::instances() const -> std::size_t {
+  return players.size();
+}
+
+auto BatchSimulation::ticks() const -> std::uint64_t { return tickCount; }
+
+auto BatchSimulation::contactCacheCounts() const -> ContactCacheCounts {
+  ContactCacheCounts total{};
+  for (const auto &counts : chunkCounts) {
+    total.hits += counts.hits;
+    total.misses += counts.misses;
+  }
+  return total;
+}
+} // namespace sbash64::game
@@ -0,0 +1,58 @@
+#include <sbash64/game/behaviours.hpp>
+#include <sbash64/game/game.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+
+namespace sbash64::game {
+constexpr std::size_t behaviourCount{100'000};
+constexpr auto ticks{600};
+constexpr std::size_t frameBytes{128};
+
+// Starts 100k chase behaviours, or alternating guard and chase ones when
+// mixed, and resumes them all each tick, moving each entity by the velocity
+// its script asked for.
+static void measure(bool mixed) {
+  const std::array<BehaviourKind, 2> kinds{
+      {{behaviourCount, frameBytes}, {behaviourCount, frameBytes}}};
+  Behaviours behaviours{kinds};
+  for (std::size_t i{0}; i < behaviourCount; ++i) {
+    const auto id{mixed && i % 2 != 0
+                      ? behaviours.start(1, guard, distance_type{0},
+                                         distance_type{500})
+                      : behaviours.start(0, chase)};
+    auto &view{behaviours.view(id)};
+    view.self = {Point{static_cast<distance_type>(i % 1000), 0}, 16, 16};
+    view.player = {Point{300, 0}, 16, 16};
+    view.awake = true;
+  }
+  const auto start{std::chrono::steady_clock::now()};
+  for (auto tick{0}; tick < ticks; ++tick) {
+    behaviours.tick();
+    for (std::size_t id{0}; id < behaviourCount; ++id) {
+      auto &view{behaviours.view(id)};
+      view.self.origin.x += view.horizontalVelocity;
+    }
+  }
+  const auto nanoseconds{std::chrono::duration<double, std::nano>{
+      std::chrono::steady_clock::now() - start}
+                             .count()};
+  std::cout << behaviourCount << (mixed ? " guard and chase" : " chase")
+            << " behaviours: " << nanoseconds / ticks / 1e6
+            << " ms per tick, "
+            << nanoseconds / ticks / static_cast<double>(behaviourCount)
+            << " ns per resume\n";
+  dump(std::cout, behaviours);
+}
+
+static auto run() -> int {
+  measure(false);
+  measure(true);
+  return EXIT_SUCCESS;
+}
+} // namespace sbash64::game
+
+int main() { return sbash64::game::run(); }
@@ -0,0 +1,174 @@
+#include <sbash64/game/behaviours.hpp>
+
+#include <coroutine>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+namespace sbash64::game {
+// Room before each frame for the pool it came from, keeping the frame
+// aligned.
+constexpr auto frameHeaderBytes{alignof(std::max_align_t)};
+
+static auto roundUp(std::size_t bytes, std::size_t multiple) -> std::size_t {
+  return (bytes + multiple - 1) / multiple * multiple;
+}
+
+FramePool::FramePool(std::size_t blocks, std::size_t blockBytes)
+    : storage{std::make_unique<std::byte[]>(
+          blocks * roundUp(frameHeaderBytes + blockBytes, frameHeaderBytes))},
+      blockBytes{roundUp(frameHeaderBytes + blockBytes, frameHeaderBytes)},
+      blocks{blocks} {
+  freeBlocks.reserve(blocks);
+  for (auto block{blocks}; block > 0; --block)
+    freeBlocks.push_back(storage.get() + (block - 1) * this->blockBytes);
+}
+
+auto FramePool::allocate(FramePool &pool, std::size_t bytes) -> void * {
+  std::byte *block{nullptr};
+  if (frameHeaderBytes + bytes <= pool.blockBytes &&
+      !pool.freeBlocks.empty()) {
+    block = pool.freeBlocks.back();
+    pool.freeBlocks.pop_back();
+    ::new (block) FramePool *{&pool};
+  } else {
+    block = static_cast<std::byte *>(::operator new(frameHeaderBytes + bytes));
+    ::new (block) FramePool *{nullptr};
+    ++pool.fallbacks;
+  }
+  return block + frameHeaderBytes;
+}
+
+void FramePool::deallocate(void *frame, std::size_t bytes) {
+  auto *const block{static_cast<std::byte *>(frame) - frameHeaderBytes};
+  auto *const pool{*std::launder(reinterpret_cast<FramePool **>(block))};
+  if (pool == nullptr)
+    ::operator delete(block, frameHeaderBytes + bytes);
+  else
+    pool->freeBlocks.push_back(block);
+}
+
+auto FramePool::blocksInUse() const -> std::size_t {
+  return blocks - freeBlocks.size();
+}
+
+auto FramePool::heapFallbacks() const -> std::size_t { return fallbacks; }
+
+Behaviour::Behaviour(std::coroutine_handle<promise_type> handle)
+    : handle{handle} {}
+
+Behaviour::~Behaviour() {
+  if (handle)
+    handle.destroy();
+}
+
+Behaviour::Behaviour(Behaviour &&other) noexcept
+    : handle{std::exchange(other.handle, nullptr)} {}
+
+auto Behaviour::operator=(Behaviour &&other) noexcept -> Behaviour & {
+  std::swap(handle, other.handle);
+  return *this;
+}
+
+void Behaviour::resume() { handle.resume(); }
+
+auto Behaviour::done() const -> bool { return handle.done(); }
+
+Behaviours::Behaviours(std::span<const BehaviourKind> kinds) {
+  std::size_t capacity{0};
+  groups.reserve(kinds.size());
+  for (const auto kind : kinds) {
+    groups.push_back({FramePool{kind.capacity, kind.frameBytes}, {}});
+    groups.back().running.reserve(kind.capacity);
+    capacity += kind.capacity;
+  }
+  views.reserve(capacity);
+}
+
+auto Behaviours::view(std::size_t id) -> BehaviourView & { return views[id]; }
+
+void Behaviours::tick() {
+  for (auto &group : groups)
+    for (auto &running : group.running)
+      if (views[running.view].awake && !running.behaviour.done())
+        running.behaviour.resume();
+}
+
+auto Behaviours::size() const -> std::size_t { return views.size(); }
+
+auto Behaviours::blocksInUse() const -> std::size_t {
+  std::size_t total{0};
+  for (const auto &group : groups)
+    total += group.pool.blocksInUse();
+  return total;
+}
+
+auto Behaviours::heapFallbacks() const -> std::size_t {
+  std::size_t total{0};
+  for (const auto &group : groups)
+    total += group.pool.heapFallbacks();
+  return total;
+}
+
+void dump(std::ostream &stream, const Behaviours &behaviours) {
+  stream << "behaviours: " << behaviours.size()
+         << ", pooled frames: " << behaviours.blocksInUse()
+         << ", heap frames: " << behaviours.heapFallbacks() << '\n';
+}
+
+static auto towards(const Rectangle &from, const Rectangle &to)
+    -> distance_type {
+  if (leftEdge(to) < leftEdge(from))
+    return -1;
+  if (leftEdge(to) > leftEdge(from))
+    return 1;
+  return 0;
+}
+
+static auto horizontalDistance(const Rectangle &a, const Rectangle &b)
+    -> distance_type {
+  return absoluteValue(leftEdge(a) + a.width / 2 - leftEdge(b) - b.width / 2);
+}
+
+auto guard(FramePool &, BehaviourView &view, distance_type left,
+           distance_type right) -> Behaviour {
+  constexpr distance_type sight{96};
+  constexpr distance_type reach{32};
+  constexpr auto alertTicks{20};
+  constexpr auto giveUpTicks{60};
+  distance_type direction{1};
+  while (true) {
+    while (horizontalDistance(view.self, view.player) > sight) {
+      if (rightEdge(view.self) >= right)
+        direction = -1;
+      else if (leftEdge(view.self) <= left)
+        direction = 1;
+      view.horizontalVelocity = direction;
+      co_await nextTick();
+    }
+    view.horizontalVelocity = 0;
+    for (auto tick{0}; tick < alertTicks; ++tick)
+      co_await nextTick();
+    for (auto unseen{0}; unseen < giveUpTicks;) {
+      view.horizontalVelocity = towards(view.self, view.player);
+      view.jump = view.jumpState == JumpState::grounded &&
+                  bottomEdge(view.player) < topEdge(view.self) &&
+                  horizontalDistance(view.self, view.player) < reach;
+      co_await nextTick();
+      unseen = horizontalDistance(view.self, view.player) > sight ? unseen + 1
+                                                                  : 0;
+    }
+    view.jump = false;
+  }
+}
+
+auto chase(FramePool &, BehaviourView &view) -> Behaviour {
+  while (true) {
+    view.horizontalVelocity = towards(view.self, view.player);
+    co_await nextTick();
+  }
+}
+} // namespace sbash64::game
@@ -0,0 +1,133 @@
+#include <sbash64/game/game.hpp>
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace sbash64::game {
+constexpr auto cases{200'000};
+constexpr std::uint64_t seed{20261018};
+
+static auto same(Rectangle a, Rectangle b) -> bool {
+  return a.origin.x == b.origin.x && a.origin.y == b.origin.y &&
+         a.width == b.width && a.height == b.height;
+}
+
+static auto same(MovingObject a, MovingObject b) -> bool {
+  return same(a.rectangle, b.rectangle) &&
+         a.velocity.vertical == b.velocity.vertical &&
+         a.velocity.horizontal == b.velocity.horizontal;
+}
+
+static auto same(PlayerState a, PlayerState b) -> bool {
+  return same(a.object, b.object) && a.jumpState == b.jumpState &&
+         a.directionFacing == b.directionFacing;
+}
+
+namespace {
+// Objects and candidates crowded around an origin so that many moves hit
+// something, with velocities both rational and whole. Positions, sizes and
+// speeds are multiplied by scale.
+class Corpus {
+public:
+  Corpus(distance_type origin, distance_type scale)
+      : origin{origin}, scale{scale} {}
+
+  auto rectangle() -> Rectangle {
+    return {Point{origin + scaled(-48, 48), origin + scaled(-48, 48)},
+            scaled(1, 24), scaled(1, 24)};
+  }
+
+  auto movingObject() -> MovingObject {
+    return {rectangle(),
+            Velocity{{scaled(-40, 40), between(1, 4)}, scaled(-12, 12)}};
+  }
+
+  auto candidates() -> std::vector<Rectangle> {
+    std::vector<Rectangle> rectangles(
+        static_cast<std::size_t>(between(0, 12)));
+    for (auto &candidate : rectangles)
+      candidate = rectangle();
+    return rectangles;
+  }
+
+private:
+  auto between(distance_type low, distance_type high) -> distance_type {
+    return std::uniform_int_distribution<distance_type>{low, high}(engine);
+  }
+
+  auto scaled(distance_type low, distance_type high) -> distance_type {
+    return between(low * scale, high * scale);
+  }
+
+  std::mt19937_64 engine{seed};
+  distance_type origin;
+  distance_type scale;
+};
+} // namespace
+
+static auto columns(const std::vector<Rectangle> &rectangles)
+    -> RectangleColumns {
+  RectangleColumns columns;
+  for (const auto rectangle : rectangles)
+    columns.push_back(rectangle);
+  return columns;
+}
+
+// Counts the moves where the batched overloads disagree with the ones that
+// test each sorted candidate with passesThrough.
+static auto mismatches(distance_type origin, distance_type scale) -> int {
+  Corpus corpus{origin, scale};
+  const Rectangle floorRectangle{
+      Point{origin - 256 * scale, origin + 96 * scale}, 512 * scale,
+      32 * scale};
+  const Rectangle levelRectangle{
+      Point{origin - 96 * scale, origin - 96 * scale}, 193 * scale,
+      193 * scale};
+  auto mismatched{0};
+  for (auto i{0}; i < cases; ++i) {
+    const PlayerState player{corpus.movingObject(), JumpState::started,
+                             DirectionFacing::right};
+    const auto fromBelow{corpus.candidates()};
+    const auto fromAbove{corpus.candidates()};
+    if (!same(handleVerticalCollisions(player, fromBelow, fromAbove,
+                                       floorRectangle),
+              handleVerticalCollisions(player, columns(fromBelow),
+                                       columns(fromAbove), floorRectangle)))
+      ++mismatched;
+    const auto object{corpus.movingObject()};
+    const auto fromRight{corpus.candidates()};
+    const auto fromLeft{corpus.candidates()};
+    if (!same(handleHorizontalCollisions(object, fromRight, fromLeft,
+                                         levelRectangle),
+              handleHorizontalCollisions(object, columns(fromRight),
+                                         columns(fromLeft), levelRectangle)))
+      ++mismatched;
+  }
+  return mismatched;
+}
+
+// Runs the corpus near zero, far from it, and scaled up until the
+// cross-multiplied comparisons would overflow distance_type.
+static auto run() -> int {
+  constexpr auto largest{std::numeric_limits<distance_type>::max()};
+  auto failed{false};
+  for (const auto &[origin, scale] :
+       {std::pair{distance_type{0}, distance_type{1}},
+        std::pair{largest / 4, distance_type{1}},
+        std::pair{distance_type{0}, largest / 4096}}) {
+    const auto mismatched{mismatches(origin, scale)};
+    std::cout << mismatched << " of " << 2 * cases
+              << " collisions differ around " << origin << " at scale "
+              << scale << '\n';
+    failed = failed || mismatched != 0;
+  }
+  return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+} // namespace sbash64::game
+
+int main() { return sbash64::game::run(); }
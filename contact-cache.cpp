@@ -0,0 +1,127 @@
+#include <sbash64/game/contact-cache.hpp>
+
+#include <cstddef>
+#include <optional>
+#include <ostream>
+
+namespace sbash64::game {
+static void validate(ContactCache &cache, std::size_t geometryVersion) {
+  if (cache.geometryVersion != geometryVersion)
+    cache = {std::nullopt, std::nullopt, std::nullopt, geometryVersion};
+}
+
+static auto overlapHorizontally(Rectangle a, Rectangle b) -> bool {
+  return leftEdge(a) <= rightEdge(b) && leftEdge(b) <= rightEdge(a);
+}
+
+static auto overlapVertically(Rectangle a, Rectangle b) -> bool {
+  return topEdge(a) <= bottomEdge(b) && topEdge(b) <= bottomEdge(a);
+}
+
+// No surface can be closer than one touching the object, so when such a
+// surface still stops it, the full search would have found it first.
+static auto standsOn(Rectangle object, Rectangle surface) -> bool {
+  return bottomEdge(object) + 1 == topEdge(surface) &&
+         overlapHorizontally(object, surface);
+}
+
+static auto touchesOnRight(Rectangle object, Rectangle wall) -> bool {
+  return rightEdge(object) + 1 == leftEdge(wall) &&
+         overlapVertically(object, wall);
+}
+
+static auto touchesOnLeft(Rectangle object, Rectangle wall) -> bool {
+  return rightEdge(wall) + 1 == leftEdge(object) &&
+         overlapVertically(object, wall);
+}
+
+auto handleVerticalCollisions(
+    PlayerState playerState, ContactCache &cache, ContactCacheCounts &counts,
+    std::size_t geometryVersion, const TileLayer &tiles,
+    RectangleColumnsView collisionFromBelowCandidates,
+    RectangleColumnsView collisionFromAboveCandidates,
+    const Rectangle &floorRectangle) -> PlayerState {
+  validate(cache, geometryVersion);
+  if (playerState.jumpState != JumpState::grounded)
+    cache.ground.reset();
+  const auto &object{playerState.object};
+  if (cache.ground && standsOn(object.rectangle, *cache.ground)) {
+    // Without vertical motion nothing can be landed on or bumped into.
+    if (round(object.velocity.vertical) == 0 &&
+        isNegative(distanceFirstExceedsSecondVertically(
+            applyVerticalVelocity(object), floorRectangle))) {
+      ++counts.hits;
+      return playerState;
+    }
+    if (passesThrough(object, *cache.ground, CollisionFromBelow{},
+                      VerticalCollision{})) {
+      ++counts.hits;
+      return onPlayerHitGround(playerState, topEdge(*cache.ground));
+    }
+  }
+  ++counts.misses;
+  cache.ground = firstSurface(object, tiles, collisionFromBelowCandidates,
+                              SweepDirection::fromBelow);
+  if (cache.ground)
+    return onPlayerHitGround(playerState, topEdge(*cache.ground));
+  if (isNonnegative(distanceFirstExceedsSecondVertically(
+          applyVerticalVelocity(object), floorRectangle)))
+    return onPlayerHitGround(playerState, topEdge(floorRectangle));
+  if (const auto ceiling{firstSurface(object, tiles,
+                                     collisionFromAboveCandidates,
+                                     SweepDirection::fromAbove)}) {
+    playerState.object.velocity.vertical = {0, 1};
+    playerState.object.rectangle.origin.y = bottomEdge(*ceiling) + 1;
+  }
+  return playerState;
+}
+
+auto handleHorizontalCollisions(
+    MovingObject object, ContactCache &cache, ContactCacheCounts &counts,
+    std::size_t geometryVersion, const TileLayer &tiles,
+    RectangleColumnsView collisionFromRightCandidates,
+    RectangleColumnsView collisionFromLeftCandidates,
+    const Rectangle &levelRectangle) -> MovingObject {
+  validate(cache, geometryVersion);
+  const auto pastLevelRight{isNonnegative(
+      rightEdge(applyHorizontalVelocity(object)) - rightEdge(levelRectangle))};
+  if (cache.rightWall && touchesOnRight(object.rectangle, *cache.rightWall) &&
+      passesThrough(object, *cache.rightWall, CollisionFromRight{},
+                    HorizontalCollision{})) {
+    ++counts.hits;
+    return collideHorizontally(object, leftEdge(*cache.rightWall) -
+                                           object.rectangle.width);
+  }
+  if (!pastLevelRight && cache.leftWall &&
+      touchesOnLeft(object.rectangle, *cache.leftWall) &&
+      passesThrough(object, *cache.leftWall, CollisionFromLeft{},
+                    HorizontalCollision{})) {
+    ++counts.hits;
+    return collideHorizontally(object, rightEdge(*cache.leftWall) + 1);
+  }
+  ++counts.misses;
+  cache.rightWall = firstSurface(object, tiles, collisionFromRightCandidates,
+                                 SweepDirection::fromRight);
+  if (cache.rightWall)
+    return collideHorizontally(object, leftEdge(*cache.rightWall) -
+                                           object.rectangle.width);
+  if (pastLevelRight)
+    return collideHorizontally(object, rightEdge(levelRectangle) -
+                                           object.rectangle.width);
+  cache.leftWall = firstSurface(object, tiles, collisionFromLeftCandidates,
+                                SweepDirection::fromLeft);
+  if (cache.leftWall)
+    return collideHorizontally(object, rightEdge(*cache.leftWall) + 1);
+  if (isNonnegative(leftEdge(levelRectangle) -
+                    leftEdge(applyHorizontalVelocity(object))))
+    return collideHorizontally(object, leftEdge(levelRectangle) + 1);
+  return object;
+}
+
+void dump(std::ostream &stream, const ContactCacheCounts &counts) {
+  const auto lookups{counts.hits + counts.misses};
+  stream << "contact cache hits/misses: " << counts.hits << '/'
+         << counts.misses << " ("
+         << (lookups == 0 ? 0 : 100 * counts.hits / lookups) << "% hit)\n";
+}
+} // namespace sbash64::game
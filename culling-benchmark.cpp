@@ -0,0 +1,98 @@
+#include <sbash64/game/components.hpp>
+#include <sbash64/game/culling-index.hpp>
+#include <sbash64/game/game.hpp>
+#include <sbash64/game/render-snapshot.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace sbash64::game {
+constexpr auto sprites{50'000};
+constexpr distance_type levelWidth{800'000};
+constexpr auto frames{300};
+constexpr distance_type scrollPerFrame{1000};
+
+static auto sprite(const Drawable &drawable, Rectangle camera)
+    -> SpriteDraw {
+  return {narrow(drawable.sprite.source),
+          relativeTo(drawable.rectangle, camera.origin), drawable.sprite.sheet,
+          drawable.directionFacing == DirectionFacing::left};
+}
+
+// Spreads 50k enemies over an 800k-pixel level and scrolls the camera
+// across it, moving only the enemies near the camera as activation would.
+// Each frame the sprites to draw are gathered as the game does, through the
+// culling index, and again by submitting every sprite, as before culling.
+static auto run() -> int {
+  std::mt19937_64 engine{36};
+  const auto between{[&](distance_type low, distance_type high) {
+    return std::uniform_int_distribution<distance_type>{low, high}(engine);
+  }};
+  GameWorld world;
+  for (auto i{0}; i < sprites; ++i)
+    world.archetype<EnemyArchetype>().create(
+        Rectangle{Point{between(0, levelWidth - 1), between(0, 223)}, 16, 16},
+        Velocity{{0, 1}, between(-2, 2)}, DirectionFacing::right,
+        Sprite{Rectangle{Point{0, 0}, 16, 16}, 1}, Scripted{},
+        MovingCollider{}, ContactCache{}, Activation{}, Animated{});
+  CullingIndex cullingIndex;
+  CullingStats stats{};
+  std::vector<SpriteDraw> culled;
+  std::vector<SpriteDraw> everything;
+  std::chrono::steady_clock::duration syncing{};
+  std::chrono::steady_clock::duration querying{};
+  std::chrono::steady_clock::duration submittingEverything{};
+  for (auto frame{0}; frame < frames; ++frame) {
+    const Rectangle camera{Point{frame * scrollPerFrame, 0}, 256, 240};
+    const Rectangle active{Point{leftEdge(camera) - 64, -64}, 384, 368};
+    world.each<Rectangle, Velocity>(
+        [&](Rectangle &rectangle, const Velocity &velocity) {
+          if (overlaps(rectangle, active))
+            rectangle.origin.x += velocity.horizontal;
+        });
+    const auto syncStart{std::chrono::steady_clock::now()};
+    cullingIndex.sync(world);
+    const auto queryStart{std::chrono::steady_clock::now()};
+    culled.clear();
+    record(stats,
+           cullingIndex.visible(world, camera, [&](const Drawable &drawable) {
+             culled.push_back(sprite(drawable, camera));
+           }));
+    const auto everythingStart{std::chrono::steady_clock::now()};
+    everything.clear();
+    world.each<Rectangle, Sprite, DirectionFacing>(
+        [&](const Rectangle &rectangle, const Sprite &drawn,
+            const DirectionFacing &directionFacing) {
+          everything.push_back(
+              sprite({rectangle, drawn, directionFacing}, camera));
+        });
+    const auto everythingEnd{std::chrono::steady_clock::now()};
+    // The first frame sorts every rectangle into the index.
+    if (frame != 0) {
+      syncing += queryStart - syncStart;
+      querying += everythingStart - queryStart;
+      submittingEverything += everythingEnd - everythingStart;
+    }
+  }
+  const auto microsecondsPerFrame{
+      [](std::chrono::steady_clock::duration duration) {
+        return std::chrono::duration<double, std::micro>{duration}.count() /
+               (frames - 1);
+      }};
+  std::cout << sprites << " sprites over " << frames << " frames: "
+            << stats.total.drawn / frames << " drawn and "
+            << stats.total.culled / frames << " culled per frame\n"
+            << "culled frame: " << microsecondsPerFrame(syncing + querying)
+            << " us (sync " << microsecondsPerFrame(syncing) << " us, query "
+            << microsecondsPerFrame(querying) << " us)\n"
+            << "unculled frame: " << microsecondsPerFrame(submittingEverything)
+            << " us to submit " << everything.size() << " sprites\n";
+  return EXIT_SUCCESS;
+}
+} // namespace sbash64::game
+
+int main() { return sbash64::game::run(); }
@@ -0,0 +1,80 @@
+#include <sbash64/game/culling-index.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+namespace sbash64::game {
+void CullingIndex::sync(GameWorld &world) {
+  std::size_t count{0};
+  widest = 0;
+  moved.clear();
+  world.each<Rectangle, Sprite, DirectionFacing>(
+      [&](const Rectangle &rectangle, const Sprite &, const DirectionFacing &) {
+        if (count == rectangles.size()) {
+          rectangles.push_back(rectangle);
+        } else {
+          if (leftEdge(rectangles[count]) != leftEdge(rectangle))
+            moved.push_back(count);
+          rectangles[count] = rectangle;
+        }
+        widest = std::max(widest, rectangle.width);
+        ++count;
+      });
+  if (count != byLeftEdge.size()) {
+    rectangles.resize(count);
+    rebuild();
+    return;
+  }
+  // Entities only move a little, so each one is shifted a few places.
+  for (const auto id : moved) {
+    auto i{position[id]};
+    byLeftEdge[i].leftEdge = leftEdge(rectangles[id]);
+    while (i > 0 && byLeftEdge[i - 1].leftEdge > byLeftEdge[i].leftEdge) {
+      swap(i - 1, i);
+      --i;
+    }
+    while (i + 1 < byLeftEdge.size() &&
+           byLeftEdge[i + 1].leftEdge < byLeftEdge[i].leftEdge) {
+      swap(i, i + 1);
+      ++i;
+    }
+  }
+}
+
+void CullingIndex::rebuild() {
+  byLeftEdge.resize(rectangles.size());
+  for (std::size_t id{0}; id < rectangles.size(); ++id)
+    byLeftEdge[id] = {leftEdge(rectangles[id]), id};
+  std::sort(byLeftEdge.begin(), byLeftEdge.end(),
+            [](Entry a, Entry b) { return a.leftEdge < b.leftEdge; });
+  position.resize(byLeftEdge.size());
+  for (std::size_t i{0}; i < byLeftEdge.size(); ++i)
+    position[byLeftEdge[i].id] = i;
+}
+
+void CullingIndex::swap(std::size_t i, std::size_t j) {
+  std::swap(byLeftEdge[i], byLeftEdge[j]);
+  position[byLeftEdge[i].id] = i;
+  position[byLeftEdge[j].id] = j;
+}
+
+void record(CullingStats &stats, CullingCounts counts) {
+  stats.latest = counts;
+  stats.total.drawn += counts.drawn;
+  stats.total.culled += counts.culled;
+  ++stats.frames;
+}
+
+void dump(std::ostream &stream, const CullingStats &stats) {
+  const auto mean{[&stats](std::size_t total) {
+    return stats.frames == 0 ? 0 : total / stats.frames;
+  }};
+  stream << "drawn/culled sprites (latest): " << stats.latest.drawn << '/'
+         << stats.latest.culled << '\n'
+         << "drawn/culled sprites (mean): " << mean(stats.total.drawn) << '/'
+         << mean(stats.total.culled) << '\n';
+}
+} // namespace sbash64::game
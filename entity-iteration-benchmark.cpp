@@ -0,0 +1,93 @@
+#include <sbash64/game/components.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+namespace sbash64::game {
+constexpr std::size_t entities{100'000};
+constexpr auto passes{200};
+
+namespace {
+// An enemy's components in one struct, as entities were laid out before
+// they were split into archetype columns.
+struct WholeEnemy {
+  Rectangle rectangle;
+  Velocity velocity;
+  DirectionFacing directionFacing;
+  Sprite sprite;
+  Scripted scripted;
+  MovingCollider movingCollider;
+  ContactCache contactCache;
+  Activation activation;
+  Animated animated;
+};
+} // namespace
+
+template <typename F> static auto nanosecondsPerEntity(F pass) -> double {
+  const auto start{std::chrono::steady_clock::now()};
+  for (auto i{0}; i < passes; ++i)
+    pass();
+  return std::chrono::duration<double, std::nano>{
+             std::chrono::steady_clock::now() - start}
+             .count() /
+         passes / entities;
+}
+
+// Moves 100k awake enemies by their horizontal velocity through
+// World::each, through the archetype's columns by hand, and through an
+// array of whole entities.
+static auto run() -> int {
+  GameWorld world;
+  auto &enemies{world.archetype<EnemyArchetype>()};
+  enemies.reserve(entities);
+  std::vector<WholeEnemy> wholeEnemies;
+  for (std::size_t i{0}; i < entities; ++i) {
+    const Rectangle rectangle{
+        Point{static_cast<distance_type>(i % 4096), 0}, 16, 16};
+    const Velocity velocity{{0, 1}, static_cast<distance_type>(i % 3) - 1};
+    enemies.create(rectangle, velocity, DirectionFacing::right, Sprite{},
+                   Scripted{}, MovingCollider{}, ContactCache{}, Activation{},
+                   Animated{});
+    wholeEnemies.push_back({rectangle, velocity, DirectionFacing::right, {},
+                            {}, {}, {}, {}, {}});
+  }
+  const auto each{nanosecondsPerEntity([&] {
+    world.each<Rectangle, Velocity, Activation>(
+        [](Rectangle &rectangle, const Velocity &velocity,
+           const Activation &activation) {
+          if (activation.awake)
+            rectangle.origin.x += velocity.horizontal;
+        });
+  })};
+  const auto columns{nanosecondsPerEntity([&] {
+    const auto rectangles{enemies.column<Rectangle>()};
+    const auto velocities{enemies.column<Velocity>()};
+    const auto activations{enemies.column<Activation>()};
+    for (std::size_t row{0}; row < enemies.size(); ++row)
+      if (activations[row].awake)
+        rectangles[row].origin.x += velocities[row].horizontal;
+  })};
+  const auto whole{nanosecondsPerEntity([&] {
+    for (auto &enemy : wholeEnemies)
+      if (enemy.activation.awake)
+        enemy.rectangle.origin.x += enemy.velocity.horizontal;
+  })};
+  distance_type checksum{0};
+  for (const auto rectangle : enemies.column<Rectangle>())
+    checksum += rectangle.origin.x;
+  for (const auto &enemy : wholeEnemies)
+    checksum += enemy.rectangle.origin.x;
+  std::cout << entities << " entities, " << passes << " passes\n"
+            << "World::each: " << each << " ns per entity\n"
+            << "archetype columns: " << columns << " ns per entity\n"
+            << "whole " << sizeof(WholeEnemy)
+            << "-byte entities: " << whole << " ns per entity\n"
+            << "checksum " << checksum << '\n';
+  return EXIT_SUCCESS;
+}
+} // namespace sbash64::game
+
+int main() { return sbash64::game::run(); }
@@ -0,0 +1,47 @@
+#include <sbash64/game/file-audio-sink.hpp>
+
+#include <sndfile.h>
+
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string>
+
+namespace sbash64::game {
+static auto waveInfo(unsigned int sampleRate) -> SF_INFO {
+  SF_INFO info{};
+  info.samplerate = static_cast<int>(sampleRate);
+  info.channels = audioChannels;
+  info.format = SF_FORMAT_WAV | SF_FORMAT_PCM_16;
+  return info;
+}
+
+FileAudioSink::FileAudioSink(AudioStats &stats, const std::string &path,
+                             unsigned int sampleRate,
+                             std::int64_t periodFrames)
+    : stats{stats}, path{path}, file{path, waveInfo(sampleRate)},
+      sampleRate{sampleRate} {
+  configure(periodFrames);
+}
+
+void FileAudioSink::configure(std::int64_t periodFrames) {
+  configuredPeriodFrames = periodFrames;
+  pacer.configure(periodFrames, sampleRate);
+  recordConfiguration(stats, periodFrames, 0, sampleRate);
+}
+
+auto FileAudioSink::periodFrames() const -> std::int64_t {
+  return configuredPeriodFrames;
+}
+
+void FileAudioSink::waitForPeriod() { pacer.wait(); }
+
+auto FileAudioSink::write(std::span<const short> interleavedPeriod) -> bool {
+  const auto frames{
+      static_cast<sf_count_t>(interleavedPeriod.size() / audioChannels)};
+  if (sf_writef_short(file.file, interleavedPeriod.data(), frames) != frames)
+    throw std::runtime_error{"Not able to write " + path + ": " +
+                             sf_strerror(file.file)};
+  return true;
+}
+} // namespace sbash64::game
@@ -0,0 +1,219 @@
+#include <sbash64/game/frame-capture.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <ostream>
+#include <span>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace sbash64::game {
+namespace {
+struct Rgba {
+  std::uint8_t r;
+  std::uint8_t g;
+  std::uint8_t b;
+  std::uint8_t a;
+
+  auto operator==(const Rgba &) const -> bool = default;
+};
+} // namespace
+
+constexpr std::uint8_t qoiIndex{0x00};
+constexpr std::uint8_t qoiDiff{0x40};
+constexpr std::uint8_t qoiLuma{0x80};
+constexpr std::uint8_t qoiRun{0xC0};
+constexpr std::uint8_t qoiRgb{0xFE};
+constexpr std::uint8_t qoiRgba{0xFF};
+constexpr auto qoiMaximumRun{62};
+
+static auto fromArgb(std::uint32_t pixel) -> Rgba {
+  return {static_cast<std::uint8_t>(pixel >> 16U),
+          static_cast<std::uint8_t>(pixel >> 8U),
+          static_cast<std::uint8_t>(pixel),
+          static_cast<std::uint8_t>(pixel >> 24U)};
+}
+
+static auto qoiHash(Rgba pixel) -> std::size_t {
+  return (pixel.r * 3U + pixel.g * 5U + pixel.b * 7U + pixel.a * 11U) % 64U;
+}
+
+static void putBigEndian(std::vector<std::uint8_t> &encoded,
+                         std::uint32_t value) {
+  for (auto shift{24}; shift >= 0; shift -= 8)
+    encoded.push_back(static_cast<std::uint8_t>(value >> shift));
+}
+
+void encodeQoi(std::span<const std::uint32_t> pixels, int width, int height,
+               std::vector<std::uint8_t> &encoded) {
+  encoded.insert(encoded.end(), {'q', 'o', 'i', 'f'});
+  putBigEndian(encoded, static_cast<std::uint32_t>(width));
+  putBigEndian(encoded, static_cast<std::uint32_t>(height));
+  encoded.push_back(4);
+  encoded.push_back(0);
+  std::array<Rgba, 64> seen{};
+  Rgba previous{0, 0, 0, 255};
+  auto run{0};
+  for (std::size_t i{0}; i < pixels.size(); ++i) {
+    const auto pixel{fromArgb(pixels[i])};
+    if (pixel == previous) {
+      ++run;
+      if (run == qoiMaximumRun || i + 1 == pixels.size()) {
+        encoded.push_back(static_cast<std::uint8_t>(qoiRun | (run - 1)));
+        run = 0;
+      }
+      continue;
+    }
+    if (run > 0) {
+      encoded.push_back(static_cast<std::uint8_t>(qoiRun | (run - 1)));
+      run = 0;
+    }
+    const auto hash{qoiHash(pixel)};
+    if (seen[hash] == pixel) {
+      encoded.push_back(static_cast<std::uint8_t>(qoiIndex | hash));
+    } else {
+      seen[hash] = pixel;
+      if (pixel.a == previous.a) {
+        const auto dr{static_cast<std::int8_t>(pixel.r - previous.r)};
+        const auto dg{static_cast<std::int8_t>(pixel.g - previous.g)};
+        const auto db{static_cast<std::int8_t>(pixel.b - previous.b)};
+        const auto drg{dr - dg};
+        const auto dbg{db - dg};
+        if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 &&
+            db <= 1)
+          encoded.push_back(static_cast<std::uint8_t>(
+              qoiDiff | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2)));
+        else if (dg >= -32 && dg <= 31 && drg >= -8 && drg <= 7 &&
+                 dbg >= -8 && dbg <= 7) {
+          encoded.push_back(static_cast<std::uint8_t>(qoiLuma | (dg + 32)));
+          encoded.push_back(static_cast<std::uint8_t>((drg + 8) << 4 |
+                                                      (dbg + 8)));
+        } else
+          encoded.insert(encoded.end(), {qoiRgb, pixel.r, pixel.g, pixel.b});
+      } else
+        encoded.insert(encoded.end(),
+                       {qoiRgba, pixel.r, pixel.g, pixel.b, pixel.a});
+    }
+    previous = pixel;
+  }
+  encoded.insert(encoded.end(), {0, 0, 0, 0, 0, 0, 0, 1});
+}
+
+// Workers share the counts, so unlike single writer stats they need atomic
+// additions.
+template <typename T> static void add(std::atomic<T> &total, T amount) {
+  total.fetch_add(amount, std::memory_order_relaxed);
+}
+
+FrameCapture::FrameCapture(std::string prefix, int width, int height,
+                           std::size_t buffers, std::size_t workers)
+    : prefix{std::move(prefix)}, imageWidth{width}, imageHeight{height},
+      buffers(buffers) {
+  for (auto &buffer : this->buffers) {
+    buffer.pixels.resize(static_cast<std::size_t>(width) *
+                         static_cast<std::size_t>(height));
+    free.push_back(&buffer);
+  }
+  for (std::size_t i{0}; i < workers; ++i)
+    this->workers.emplace_back([this] { work(); });
+}
+
+FrameCapture::~FrameCapture() {
+  {
+    std::lock_guard lock{mutex};
+    stopping = true;
+  }
+  ready.notify_all();
+  for (auto &worker : workers)
+    worker.join();
+}
+
+auto FrameCapture::acquire() -> CaptureBuffer * {
+  std::lock_guard lock{mutex};
+  if (free.empty()) {
+    ++frames;
+    add(frameCounts.dropped, std::uint64_t{1});
+    return nullptr;
+  }
+  auto *buffer{free.back()};
+  free.pop_back();
+  buffer->frame = frames++;
+  return buffer;
+}
+
+void FrameCapture::submit(CaptureBuffer &buffer) {
+  {
+    std::lock_guard lock{mutex};
+    queued.push_back(&buffer);
+  }
+  add(frameCounts.captured, std::uint64_t{1});
+  ready.notify_one();
+}
+
+auto FrameCapture::width() const -> int { return imageWidth; }
+
+auto FrameCapture::height() const -> int { return imageHeight; }
+
+auto FrameCapture::counts() const -> const Counts & { return frameCounts; }
+
+// Each worker reuses its encoding buffer, so once it has grown to fit a
+// frame nothing more is allocated.
+void FrameCapture::work() {
+  std::vector<std::uint8_t> encoded;
+  while (true) {
+    CaptureBuffer *buffer{nullptr};
+    {
+      std::unique_lock lock{mutex};
+      ready.wait(lock, [this] { return stopping || !queued.empty(); });
+      if (queued.empty())
+        return;
+      buffer = queued.front();
+      queued.pop_front();
+    }
+    const auto start{std::chrono::steady_clock::now()};
+    encoded.clear();
+    encodeQoi(buffer->pixels, imageWidth, imageHeight, encoded);
+    std::stringstream path;
+    path << prefix << '-' << std::setw(6) << std::setfill('0')
+         << buffer->frame << ".qoi";
+    {
+      std::lock_guard lock{mutex};
+      free.push_back(buffer);
+    }
+    add(frameCounts.encodeNanoseconds,
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start)
+            .count());
+    std::ofstream file{path.str(), std::ios::binary};
+    file.write(reinterpret_cast<const char *>(encoded.data()),
+               static_cast<std::streamsize>(encoded.size()));
+    if (file) {
+      add(frameCounts.written, std::uint64_t{1});
+      add(frameCounts.encodedBytes, std::uint64_t{encoded.size()});
+    } else
+      add(frameCounts.failed, std::uint64_t{1});
+  }
+}
+
+void dump(std::ostream &stream, const FrameCapture &capture) {
+  const auto &counts{capture.counts()};
+  const auto written{counts.written.load()};
+  stream << "frame capture captured/dropped: " << counts.captured << '/'
+         << counts.dropped << ", written: " << written
+         << ", failed: " << counts.failed;
+  if (written != 0)
+    stream << ", average " << counts.encodedBytes / written
+           << " bytes encoded in "
+           << counts.encodeNanoseconds / static_cast<std::int64_t>(written) /
+                  1000
+           << " us";
+  stream << '\n';
+}
+} // namespace sbash64::game
@@ -0,0 +1,33 @@
+#include <sbash64/game/frame-times.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+
+namespace sbash64::game {
+void record(FrameTimes &times, std::chrono::nanoseconds duration) {
+  const auto nanoseconds{static_cast<std::int64_t>(duration.count())};
+  times.latestNanoseconds = nanoseconds;
+  times.maximumNanoseconds = std::max(times.maximumNanoseconds, nanoseconds);
+  times.totalNanoseconds += nanoseconds;
+  ++times.frames;
+}
+
+static auto microseconds(std::int64_t nanoseconds) -> std::int64_t {
+  return nanoseconds / 1000;
+}
+
+void dump(std::ostream &stream, std::string_view name,
+          const FrameTimes &times) {
+  const auto mean{
+      times.frames == 0
+          ? 0
+          : times.totalNanoseconds / static_cast<std::int64_t>(times.frames)};
+  stream << name << " frames: " << times.frames << '\n'
+         << name << " frame us (latest/mean/max): "
+         << microseconds(times.latestNanoseconds) << '/' << microseconds(mean)
+         << '/' << microseconds(times.maximumNanoseconds) << '\n';
+}
+} // namespace sbash64::game
@@ -1,8 +1,11 @@
 #include <sbash64/game/game.hpp>
 
 #include <algorithm>
+#include <cstddef>
 #include <cstdlib>
 #include <limits>
+#include <optional>
+#include <span>
 #include <vector>
 
 namespace sbash64::game {
@@ -241,41 +244,37 @@ static auto collideVertically(MovingObject object, distance_type ground)
   return object;
 }
 
-static auto onPlayerHitGround(PlayerState playerState, distance_type ground)
+auto onPlayerHitGround(PlayerState playerState, distance_type ground)
     -> PlayerState {
   playerState.object = collideVertically(playerState.object, ground);
   playerState.jumpState = JumpState::grounded;
   return playerState;
 }
 
-static auto sortByTopEdge(std::vector<Rectangle> objects)
-    -> std::vector<Rectangle> {
+void sortByTopEdge(std::span<Rectangle> objects) {
   std::sort(objects.begin(), objects.end(),
             [](Rectangle a, Rectangle b) { return topEdge(a) < topEdge(b); });
-  return objects;
 }
 
-static auto sortByBottomEdge(std::vector<Rectangle> objects)
-    -> std::vector<Rectangle> {
+void sortByBottomEdge(std::span<Rectangle> objects) {
   std::sort(objects.begin(), objects.end(), [](Rectangle a, Rectangle b) {
     return bottomEdge(a) > bottomEdge(b);
   });
-  return objects;
 }
 
-auto handleVerticalCollisions(
+auto handleSortedVerticalCollisions(
     PlayerState playerState,
-    const std::vector<Rectangle> &collisionFromBelowCandidates,
-    const std::vector<Rectangle> &collisionFromAboveCandidates,
+    std::span<const Rectangle> collisionFromBelowCandidatesSortedByTopEdge,
+    std::span<const Rectangle> collisionFromAboveCandidatesSortedByBottomEdge,
     const Rectangle &floorRectangle) -> PlayerState {
-  for (const auto candidate : sortByTopEdge(collisionFromBelowCandidates))
+  for (const auto candidate : collisionFromBelowCandidatesSortedByTopEdge)
     if (passesThrough(playerState.object, candidate, CollisionFromBelow{},
                       VerticalCollision{}))
       return onPlayerHitGround(playerState, topEdge(candidate));
   if (isNonnegative(distanceFirstExceedsSecondVertically(
           applyVerticalVelocity(playerState.object), floorRectangle)))
     return onPlayerHitGround(playerState, topEdge(floorRectangle));
-  for (const auto object : sortByBottomEdge(collisionFromAboveCandidates))
+  for (const auto object : collisionFromAboveCandidatesSortedByBottomEdge)
     if (passesThrough(playerState.object, object, CollisionFromAbove{},
                       VerticalCollision{})) {
       playerState.object.velocity.vertical = {0, 1};
@@ -285,34 +284,43 @@ auto handleVerticalCollisions(
   return playerState;
 }
 
-static auto sortByLeftEdge(std::vector<Rectangle> objects)
-    -> std::vector<Rectangle> {
+auto handleVerticalCollisions(
+    PlayerState playerState,
+    const std::vector<Rectangle> &collisionFromBelowCandidates,
+    const std::vector<Rectangle> &collisionFromAboveCandidates,
+    const Rectangle &floorRectangle) -> PlayerState {
+  auto sortedFromBelow{collisionFromBelowCandidates};
+  sortByTopEdge(sortedFromBelow);
+  auto sortedFromAbove{collisionFromAboveCandidates};
+  sortByBottomEdge(sortedFromAbove);
+  return handleSortedVerticalCollisions(playerState, sortedFromBelow,
+                                        sortedFromAbove, floorRectangle);
+}
+
+void sortByLeftEdge(std::span<Rectangle> objects) {
   std::sort(objects.begin(), objects.end(),
             [](Rectangle a, Rectangle b) { return leftEdge(a) < leftEdge(b); });
-  return objects;
 }
 
-static auto sortByRightEdge(std::vector<Rectangle> objects)
-    -> std::vector<Rectangle> {
+void sortByRightEdge(std::span<Rectangle> objects) {
   std::sort(objects.begin(), objects.end(), [](Rectangle a, Rectangle b) {
     return rightEdge(a) > rightEdge(b);
   });
-  return objects;
 }
 
-static auto collideHorizontally(MovingObject object, distance_type leftEdge)
+auto collideHorizontally(MovingObject object, distance_type leftEdge)
     -> MovingObject {
   object.velocity.horizontal = 0;
   object.rectangle.origin.x = leftEdge;
   return object;
 }
 
-auto handleHorizontalCollisions(
+auto handleSortedHorizontalCollisions(
     MovingObject object,
-    const std::vector<Rectangle> &collisionFromRightCandidates,
-    const std::vector<Rectangle> &collisionFromLeftCandidates,
+    std::span<const Rectangle> collisionFromRightCandidatesSortedByLeftEdge,
+    std::span<const Rectangle> collisionFromLeftCandidatesSortedByRightEdge,
     const Rectangle &levelRectangle) -> MovingObject {
-  for (const auto candidate : sortByLeftEdge(collisionFromRightCandidates))
+  for (const auto candidate : collisionFromRightCandidatesSortedByLeftEdge)
     if (passesThrough(object, candidate, CollisionFromRight{},
                       HorizontalCollision{}))
       return collideHorizontally(object,
@@ -322,7 +330,7 @@ auto handleHorizontalCollisions(
     return collideHorizontally(object, rightEdge(levelRectangle) -
                                            object.rectangle.width);
 
-  for (const auto candidate : sortByRightEdge(collisionFromLeftCandidates))
+  for (const auto candidate : collisionFromLeftCandidatesSortedByRightEdge)
     if (passesThrough(object, candidate, CollisionFromLeft{},
                       HorizontalCollision{}))
       return collideHorizontally(object, rightEdge(candidate) + 1);
@@ -332,6 +340,183 @@ auto handleHorizontalCollisions(
   return object;
 }
 
+auto handleHorizontalCollisions(
+    MovingObject object,
+    const std::vector<Rectangle> &collisionFromRightCandidates,
+    const std::vector<Rectangle> &collisionFromLeftCandidates,
+    const Rectangle &levelRectangle) -> MovingObject {
+  auto sortedFromRight{collisionFromRightCandidates};
+  sortByLeftEdge(sortedFromRight);
+  auto sortedFromLeft{collisionFromLeftCandidates};
+  sortByRightEdge(sortedFromLeft);
+  return handleSortedHorizontalCollisions(object, sortedFromRight,
+                                          sortedFromLeft, levelRectangle);
+}
+
+namespace {
+// passesThrough specialized for one direction and one moving object, with
+// the candidate's edges read from columns. Every term is computed without
+// branching on the candidate so that loops over candidates vectorize.
+struct Sweep {
+  const distance_type *normalEdges;
+  const distance_type *lowParallelEdges;
+  const distance_type *highParallelEdges;
+  distance_type normalSign;
+  distance_type movingNormalEdge;
+  distance_type normalDisplacement;
+  distance_type normalSpeed;
+  distance_type movingLowParallelEdge;
+  distance_type movingHighParallelEdge;
+  distance_type parallelDisplacement;
+
+  [[nodiscard]] auto penetration(std::size_t i) const -> distance_type {
+    return normalSign * (movingNormalEdge - normalEdges[i]);
+  }
+
+  [[nodiscard]] auto key(std::size_t i) const -> distance_type {
+    return normalSign * normalEdges[i];
+  }
+
+  [[nodiscard]] auto passes(std::size_t i) const -> bool {
+    const auto before{penetration(i)};
+    const auto after{before + normalSign * normalDisplacement};
+    const auto movingExceeds{movingHighParallelEdge - lowParallelEdges[i]};
+    const auto candidateExceeds{highParallelEdges[i] - movingLowParallelEdge};
+    const auto t{parallelDisplacement};
+    const auto headingUpper{t > 0};
+    const auto headingLower{t < 0};
+    const auto towardUpper{isNegative(movingExceeds) | headingUpper};
+    const auto towardLower{(towardUpper == 0) &
+                           (isNegative(candidateExceeds) | headingLower)};
+    const auto passesUpper{
+        headingUpper & isNonnegative(movingExceeds + t) &
+        isNonnegative(candidateExceeds) &
+        (product(-(before + 1), t) <
+         product(normalSpeed, candidateExceeds + 1))};
+    const auto passesLower{
+        headingLower & isNonnegative(candidateExceeds - t) &
+        isNonnegative(movingExceeds) &
+        (product(normalSpeed, movingExceeds + 1) > product(before + 1, t))};
+    return (isNegative(before) & isNonnegative(after) &
+            ((towardUpper & passesUpper) | (towardLower & passesLower) |
+             static_cast<int>((towardUpper | towardLower) == 0))) != 0;
+  }
+};
+} // namespace
+
+static auto sweep(MovingObject movingObject, RectangleColumnsView candidates,
+                  SweepDirection direction) -> Sweep {
+  const auto vertical{round(movingObject.velocity.vertical)};
+  const auto horizontal{movingObject.velocity.horizontal};
+  const auto rectangle{movingObject.rectangle};
+  switch (direction) {
+  case SweepDirection::fromBelow:
+    return {candidates.top.data(), candidates.left.data(),
+            candidates.right.data(), 1,
+            bottomEdge(rectangle), vertical,
+            absoluteValue(vertical), leftEdge(rectangle),
+            rightEdge(rectangle), horizontal};
+  case SweepDirection::fromAbove:
+    return {candidates.bottom.data(), candidates.left.data(),
+            candidates.right.data(), -1,
+            topEdge(rectangle), vertical,
+            absoluteValue(vertical), leftEdge(rectangle),
+            rightEdge(rectangle), horizontal};
+  case SweepDirection::fromRight:
+    return {candidates.left.data(), candidates.top.data(),
+            candidates.bottom.data(), 1,
+            rightEdge(rectangle), horizontal,
+            absoluteValue(horizontal), topEdge(rectangle),
+            bottomEdge(rectangle), vertical};
+  case SweepDirection::fromLeft:
+  default:
+    return {candidates.right.data(), candidates.top.data(),
+            candidates.bottom.data(), -1,
+            leftEdge(rectangle), horizontal,
+            absoluteValue(horizontal), topEdge(rectangle),
+            bottomEdge(rectangle), vertical};
+  }
+}
+
+static auto surfaceNormal(SweepDirection direction) -> Point {
+  switch (direction) {
+  case SweepDirection::fromBelow:
+    return {0, -1};
+  case SweepDirection::fromAbove:
+    return {0, 1};
+  case SweepDirection::fromRight:
+    return {-1, 0};
+  case SweepDirection::fromLeft:
+  default:
+    return {1, 0};
+  }
+}
+
+auto earliestHit(MovingObject movingObject, RectangleColumnsView candidates,
+                 SweepDirection direction) -> std::optional<SweptHit> {
+  const auto s{sweep(movingObject, candidates, direction)};
+  const auto count{candidates.size()};
+  constexpr auto noHit{std::numeric_limits<distance_type>::max()};
+  auto earliest{noHit};
+  for (std::size_t i{0}; i < count; ++i) {
+    const auto passes{static_cast<distance_type>(s.passes(i))};
+    earliest = std::min(earliest, passes * s.key(i) + (1 - passes) * noHit);
+  }
+  if (earliest == noHit)
+    return std::nullopt;
+  for (std::size_t i{0}; i < count; ++i)
+    if (s.key(i) == earliest && s.passes(i))
+      return SweptHit{i, RationalDistance{-s.penetration(i), s.normalSpeed},
+                      surfaceNormal(direction)};
+  return std::nullopt;
+}
+
+auto handleVerticalCollisions(
+    PlayerState playerState,
+    RectangleColumnsView collisionFromBelowCandidates,
+    RectangleColumnsView collisionFromAboveCandidates,
+    const Rectangle &floorRectangle) -> PlayerState {
+  if (const auto hit{earliestHit(playerState.object,
+                                 collisionFromBelowCandidates,
+                                 SweepDirection::fromBelow)})
+    return onPlayerHitGround(playerState,
+                             collisionFromBelowCandidates.top[hit->index]);
+  if (isNonnegative(distanceFirstExceedsSecondVertically(
+          applyVerticalVelocity(playerState.object), floorRectangle)))
+    return onPlayerHitGround(playerState, topEdge(floorRectangle));
+  if (const auto hit{earliestHit(playerState.object,
+                                 collisionFromAboveCandidates,
+                                 SweepDirection::fromAbove)}) {
+    playerState.object.velocity.vertical = {0, 1};
+    playerState.object.rectangle.origin.y =
+        collisionFromAboveCandidates.bottom[hit->index] + 1;
+  }
+  return playerState;
+}
+
+auto handleHorizontalCollisions(
+    MovingObject object, RectangleColumnsView collisionFromRightCandidates,
+    RectangleColumnsView collisionFromLeftCandidates,
+    const Rectangle &levelRectangle) -> MovingObject {
+  if (const auto hit{earliestHit(object, collisionFromRightCandidates,
+                                 SweepDirection::fromRight)})
+    return collideHorizontally(
+        object, collisionFromRightCandidates.left[hit->index] -
+                    object.rectangle.width);
+  if (isNonnegative(rightEdge(applyHorizontalVelocity(object)) -
+                    rightEdge(levelRectangle)))
+    return collideHorizontally(object, rightEdge(levelRectangle) -
+                                           object.rectangle.width);
+  if (const auto hit{earliestHit(object, collisionFromLeftCandidates,
+                                 SweepDirection::fromLeft)})
+    return collideHorizontally(
+        object, collisionFromLeftCandidates.right[hit->index] + 1);
+  if (isNonnegative(leftEdge(levelRectangle) -
+                    leftEdge(applyHorizontalVelocity(object))))
+    return collideHorizontally(object, leftEdge(levelRectangle) + 1);
+  return object;
+}
+
 auto shiftBackground(Rectangle backgroundSourceRectangle,
                      distance_type backgroundSourceWidth,
                      const Rectangle &playerRectangle,
@@ -359,4 +544,78 @@ auto applyVelocity(MovingObject object) -> MovingObject {
       applyVerticalVelocity({applyHorizontalVelocity(object), object.velocity});
   return object;
 }
+
+auto applyHorizontalForces(PlayerState playerState, PlayerInput input,
+                           distance_type groundFriction,
+                           distance_type playerMaxHorizontalSpeed,
+                           distance_type playerRunAcceleration) -> PlayerState {
+  if (input.left) {
+    playerState.object.velocity.horizontal -= playerRunAcceleration;
+    playerState.directionFacing = DirectionFacing::left;
+  }
+  if (input.right) {
+    playerState.object.velocity.horizontal += playerRunAcceleration;
+    playerState.directionFacing = DirectionFacing::right;
+  }
+  playerState.object.velocity.horizontal = withFriction(
+      clamp(playerState.object.velocity.horizontal, playerMaxHorizontalSpeed),
+      groundFriction);
+  return playerState;
+}
+
+auto applyVerticalForces(PlayerState playerState, PlayerInput input,
+                         distance_type playerJumpAcceleration,
+                         RationalDistance gravity) -> PlayerState {
+  if (input.jump && playerState.jumpState == JumpState::grounded) {
+    playerState.jumpState = JumpState::started;
+    playerState.object.velocity.vertical += playerJumpAcceleration;
+  }
+  playerState.object.velocity.vertical += gravity;
+  if (!input.jump && playerState.jumpState == JumpState::started) {
+    playerState.jumpState = JumpState::released;
+    if (playerState.object.velocity.vertical < 0)
+      playerState.object.velocity.vertical = {0, 1};
+  }
+  return playerState;
+}
+
+static auto relativeTo(MovingObject object, Velocity frame) -> MovingObject {
+  object.velocity.horizontal -= frame.horizontal;
+  object.velocity.vertical = object.velocity.vertical + -frame.vertical;
+  return object;
+}
+
+static auto stopHorizontally(MovingObject first, MovingObject second,
+                             distance_type firstLeftEdge)
+    -> MovingCollisionResult {
+  first.rectangle.origin.x = firstLeftEdge;
+  first.velocity.horizontal = 0;
+  second.velocity.horizontal = 0;
+  return {first, second, MovingCollision::horizontal};
+}
+
+static auto land(MovingObject top, MovingObject bottom) -> MovingObject {
+  top.rectangle.origin.y = topEdge(bottom.rectangle) - top.rectangle.height;
+  top.velocity.vertical = bottom.velocity.vertical;
+  return top;
+}
+
+auto handleMovingCollision(MovingObject first, MovingObject second)
+    -> MovingCollisionResult {
+  const auto relative{relativeTo(first, second.velocity)};
+  if (passesThrough(relative, second.rectangle, CollisionFromBelow{},
+                    VerticalCollision{}))
+    return {land(first, second), second, MovingCollision::firstLanded};
+  if (passesThrough(relative, second.rectangle, CollisionFromAbove{},
+                    VerticalCollision{}))
+    return {first, land(second, first), MovingCollision::secondLanded};
+  if (passesThrough(relative, second.rectangle, CollisionFromRight{},
+                    HorizontalCollision{}))
+    return stopHorizontally(first, second,
+                            leftEdge(second.rectangle) - first.rectangle.width);
+  if (passesThrough(relative, second.rectangle, CollisionFromLeft{},
+                    HorizontalCollision{}))
+    return stopHorizontally(first, second, rightEdge(second.rectangle) + 1);
+  return {first, second, MovingCollision::none};
+}
 } // namespace sbash64::game
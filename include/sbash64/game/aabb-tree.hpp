@@ -0,0 +1,84 @@
+#ifndef SBASH64_GAME_AABB_TREE_HPP_
+#define SBASH64_GAME_AABB_TREE_HPP_
+
+#include <sbash64/game/game.hpp>
+
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace sbash64::game {
+using CandidatePair = std::pair<std::size_t, std::size_t>;
+
+// Bounding volume hierarchy over moving objects. Leaves store a rectangle
+// enlarged by a margin so small motions don't require reinsertion, and the
+// tree is kept balanced with rotations.
+class DynamicAabbTree {
+public:
+  static constexpr auto nullNode{std::numeric_limits<std::size_t>::max()};
+
+  explicit DynamicAabbTree(distance_type fatMargin);
+  auto insert(Rectangle, std::size_t userData) -> std::size_t;
+  void remove(std::size_t proxy);
+  // Returns true when the proxy had to be reinserted.
+  auto move(std::size_t proxy, Rectangle) -> bool;
+  [[nodiscard]] auto fatRectangle(std::size_t proxy) const -> Rectangle;
+  [[nodiscard]] auto userData(std::size_t proxy) const -> std::size_t;
+  void setUserData(std::size_t proxy, std::size_t userData);
+  [[nodiscard]] auto height() const -> int;
+  [[nodiscard]] auto leafCount() const -> std::size_t;
+  // Appends each overlapping pair of leaves once, as user data ordered
+  // (smaller, larger).
+  void candidatePairs(std::vector<CandidatePair> &pairs);
+
+  template <typename F> void query(Rectangle rectangle, F f) {
+    if (root == nullNode)
+      return;
+    stack.clear();
+    stack.push_back(root);
+    while (!stack.empty()) {
+      const auto index{stack.back()};
+      stack.pop_back();
+      const auto &node{nodes[index]};
+      if (!overlaps(node.rectangle, rectangle))
+        continue;
+      if (node.leaf()) {
+        f(index);
+      } else {
+        stack.push_back(node.first);
+        stack.push_back(node.second);
+      }
+    }
+  }
+
+private:
+  struct Node {
+    Rectangle rectangle;
+    std::size_t parent;
+    std::size_t first;
+    std::size_t second;
+    std::size_t userData;
+    int height;
+
+    [[nodiscard]] auto leaf() const -> bool { return first == nullNode; }
+  };
+
+  auto allocate() -> std::size_t;
+  void release(std::size_t);
+  void insertLeaf(std::size_t leaf);
+  void removeLeaf(std::size_t leaf);
+  void refit(std::size_t index);
+  auto balance(std::size_t index) -> std::size_t;
+  auto rotate(std::size_t index, std::size_t child) -> std::size_t;
+
+  std::vector<Node> nodes;
+  std::vector<std::size_t> stack;
+  std::size_t root{nullNode};
+  std::size_t freeList{nullNode};
+  std::size_t leaves{0};
+  distance_type fatMargin;
+};
+} // namespace sbash64::game
+
+#endif
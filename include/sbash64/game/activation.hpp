@@ -0,0 +1,39 @@
+#ifndef SBASH64_GAME_ACTIVATION_HPP_
+#define SBASH64_GAME_ACTIVATION_HPP_
+
+#include <sbash64/game/components.hpp>
+#include <sbash64/game/game.hpp>
+
+#include <cstddef>
+#include <ostream>
+
+namespace sbash64::game {
+struct ActivationCounts {
+  std::size_t active;
+  std::size_t sleeping;
+};
+
+struct ActivationStats {
+  std::size_t frames;
+  ActivationCounts latest;
+  ActivationCounts maximum;
+  ActivationCounts total;
+};
+
+// The camera grown by margin on every side.
+constexpr auto activationRegion(Rectangle camera, distance_type margin)
+    -> Rectangle {
+  return {Point{leftEdge(camera) - margin, topEdge(camera) - margin},
+          camera.width + 2 * margin, camera.height + 2 * margin};
+}
+
+// Wakes every entity overlapping the region and puts the rest to sleep.
+// Depends only on positions, so entities wake on the same frame every run.
+auto updateActivation(GameWorld &, Rectangle region) -> ActivationCounts;
+
+void record(ActivationStats &, ActivationCounts);
+
+void dump(std::ostream &, const ActivationStats &);
+} // namespace sbash64::game
+
+#endif
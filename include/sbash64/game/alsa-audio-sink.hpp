@@ -0,0 +1,34 @@
+#ifndef SBASH64_GAME_ALSA_AUDIO_SINK_HPP_
+#define SBASH64_GAME_ALSA_AUDIO_SINK_HPP_
+
+#include <sbash64/game/alsa-wrappers.hpp>
+#include <sbash64/game/audio-sink.hpp>
+#include <sbash64/game/audio-stats.hpp>
+
+#include <cstdint>
+#include <optional>
+#include <span>
+
+namespace sbash64::game {
+class AlsaAudioSink : public AudioSink {
+public:
+  AlsaAudioSink(AudioStats &, unsigned int sampleRate,
+                std::int64_t periodFrames);
+  void configure(std::int64_t periodFrames) override;
+  [[nodiscard]] auto periodFrames() const -> std::int64_t override;
+  void waitForPeriod() override;
+  [[nodiscard]] auto write(std::span<const short> interleavedPeriod)
+      -> bool override;
+
+private:
+  // Only the first opening dumps the device's setup.
+  void open(std::int64_t periodFrames, bool dump);
+
+  AudioStats &stats;
+  std::optional<alsa_wrappers::PCM> pcm;
+  unsigned int sampleRate;
+  std::int64_t grantedPeriodFrames{};
+};
+} // namespace sbash64::game
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef SBASH64_GAME_ANIMATION_TABLE_HPP_
+#define SBASH64_GAME_ANIMATION_TABLE_HPP_
+
+#include <sbash64/game/components.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sbash64::game {
+struct TimedFrame {
+  // The sheet is the index of the atlas holding the frame.
+  Sprite sprite;
+  std::uint16_t ticks;
+};
+
+struct AnimationDefinition {
+  std::string name;
+  std::vector<TimedFrame> frames;
+};
+
+// Writes the binary form read by AnimationTable: a header, then each
+// animation's name and frames as little-endian 16-bit fields.
+void writeAnimationTable(std::ostream &,
+                         std::span<const AnimationDefinition>,
+                         std::size_t atlases);
+
+// Looping animations whose frames are found in constant time by indexing
+// a table of which frame shows on each tick of the loop.
+class AnimationTable {
+public:
+  // Throws when the table is malformed.
+  explicit AnimationTable(std::istream &);
+
+  // Throws when there is no animation with the name.
+  [[nodiscard]] auto find(std::string_view name) const -> std::uint32_t;
+
+  [[nodiscard]] auto sprite(std::uint32_t animation, std::uint64_t tick) const
+      -> Sprite {
+    const auto &loop{loops[animation]};
+    return frames[frameOfTick[loop.firstTick + tick % loop.ticks]];
+  }
+
+  [[nodiscard]] auto atlases() const -> std::size_t;
+
+private:
+  struct Loop {
+    std::size_t firstTick;
+    std::size_t ticks;
+  };
+
+  std::vector<std::string> names;
+  std::vector<Loop> loops;
+  std::vector<Sprite> frames;
+  std::vector<std::uint32_t> frameOfTick;
+  std::size_t atlasCount;
+};
+} // namespace sbash64::game
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef SBASH64_GAME_ATLAS_PACKER_HPP_
+#define SBASH64_GAME_ATLAS_PACKER_HPP_
+
+#include <sbash64/game/game.hpp>
+
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace sbash64::game {
+// Places rectangles in a fixed-size atlas by keeping the top outline of
+// everything placed so far and putting each rectangle where its bottom
+// ends highest, then leftmost.
+class SkylinePacker {
+public:
+  SkylinePacker(distance_type width, distance_type height);
+  auto insert(distance_type width, distance_type height)
+      -> std::optional<Point>;
+
+private:
+  struct Segment {
+    distance_type x;
+    distance_type y;
+    distance_type width;
+  };
+
+  // The top of a rectangle of the given width resting on the skyline from
+  // segment first on, if it fits.
+  [[nodiscard]] auto restingTop(std::size_t first, distance_type width,
+                                distance_type height) const
+      -> std::optional<distance_type>;
+
+  std::vector<Segment> skyline;
+  distance_type width;
+  distance_type height;
+};
+
+struct AtlasPlacement {
+  std::size_t atlas;
+  Point origin;
+};
+
+// Packs rectangles of the given sizes, tallest first, into as few atlases
+// as it can, leaving padding to the right of and below each one. Throws
+// when a rectangle cannot fit an empty atlas.
+auto packAtlases(std::span<const Rectangle> sizes, distance_type atlasWidth,
+                 distance_type atlasHeight, distance_type padding)
+    -> std::vector<AtlasPlacement>;
+} // namespace sbash64::game
+
+#endif
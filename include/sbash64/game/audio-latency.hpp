@@ -0,0 +1,43 @@
+#ifndef SBASH64_GAME_AUDIO_LATENCY_HPP_
+#define SBASH64_GAME_AUDIO_LATENCY_HPP_
+
+#include <cstdint>
+
+namespace sbash64::game {
+struct AudioLatencyTuning {
+  std::int64_t minimumPeriodFrames;
+  std::int64_t maximumPeriodFrames;
+  std::uint64_t xrunsBeforeGrowing;
+  std::int64_t stableFramesBeforeShrinking;
+};
+
+struct PeriodSizeTuner {
+  std::int64_t periodFrames;
+  std::int64_t largestUnstablePeriodFrames;
+  std::uint64_t xruns;
+  std::int64_t stableFrames;
+};
+
+constexpr auto fixedLatency(std::int64_t periodFrames) -> AudioLatencyTuning {
+  return {periodFrames, periodFrames, 0, 0};
+}
+
+constexpr auto autoTuned(const AudioLatencyTuning &tuning) -> bool {
+  return tuning.minimumPeriodFrames < tuning.maximumPeriodFrames;
+}
+
+auto startTuning(const AudioLatencyTuning &) -> PeriodSizeTuner;
+
+auto afterXrun(PeriodSizeTuner, const AudioLatencyTuning &) -> PeriodSizeTuner;
+
+auto afterPeriodWritten(PeriodSizeTuner, const AudioLatencyTuning &)
+    -> PeriodSizeTuner;
+
+// Takes the period size a sink granted in place of the one asked for. A size
+// that was rounded up or refused is treated as unstable so that it is not
+// asked for again.
+auto afterConfigured(PeriodSizeTuner, std::int64_t grantedPeriodFrames)
+    -> PeriodSizeTuner;
+} // namespace sbash64::game
+
+#endif
@@ -0,0 +1,24 @@
+#ifndef SBASH64_GAME_AUDIO_MIXER_HPP_
+#define SBASH64_GAME_AUDIO_MIXER_HPP_
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace sbash64::game {
+struct AudioMixer {
+  std::ptrdiff_t backgroundMusicDataOffset;
+  std::ptrdiff_t jumpSoundDataOffset;
+  bool playingJumpSound;
+};
+
+void startJumpSound(AudioMixer &);
+
+void mix(AudioMixer &, std::span<short> interleavedPeriod,
+         const std::vector<short> &backgroundMusicData,
+         const std::vector<short> &jumpSoundData);
+
+void advance(AudioMixer &, std::ptrdiff_t periodFrames);
+} // namespace sbash64::game
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef SBASH64_GAME_AUDIO_SINK_HPP_
+#define SBASH64_GAME_AUDIO_SINK_HPP_
+
+#include <sbash64/game/audio-stats.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <span>
+
+namespace sbash64::game {
+constexpr auto audioChannels{2};
+
+class AudioSink {
+public:
+  virtual ~AudioSink() = default;
+  virtual void configure(std::int64_t periodFrames) = 0;
+  // The period size in effect, which may differ from the one asked for.
+  [[nodiscard]] virtual auto periodFrames() const -> std::int64_t = 0;
+  virtual void waitForPeriod() = 0;
+  // Returns false when the period was dropped because of an underrun.
+  [[nodiscard]] virtual auto write(std::span<const short> interleavedPeriod)
+      -> bool = 0;
+};
+
+// Paces a sink without a device, such as a file, by sleeping for a period at
+// a time, so that periods are consumed in real time.
+class PeriodPacer {
+public:
+  void configure(std::int64_t periodFrames, unsigned int sampleRate);
+  void wait();
+
+private:
+  std::chrono::steady_clock::time_point nextPeriod{
+      std::chrono::steady_clock::now()};
+  std::chrono::nanoseconds periodDuration{};
+};
+
+// Discards periods as fast as they are mixed, for measuring the mixer's
+// throughput.
+class NullAudioSink : public AudioSink {
+public:
+  NullAudioSink(AudioStats &, unsigned int sampleRate,
+                std::int64_t periodFrames);
+  void configure(std::int64_t periodFrames) override;
+  [[nodiscard]] auto periodFrames() const -> std::int64_t override;
+  void waitForPeriod() override;
+  [[nodiscard]] auto write(std::span<const short> interleavedPeriod)
+      -> bool override;
+
+private:
+  AudioStats &stats;
+  unsigned int sampleRate;
+  std::int64_t configuredPeriodFrames{};
+};
+} // namespace sbash64::game
+
+#endif
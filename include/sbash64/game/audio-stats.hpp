@@ -0,0 +1,60 @@
+#ifndef SBASH64_GAME_AUDIO_STATS_HPP_
+#define SBASH64_GAME_AUDIO_STATS_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <ostream>
+
+namespace sbash64::game {
+// Written only by the audio thread; any other thread may read the fields
+// individually without locking.
+struct AudioStats {
+  std::atomic<std::int64_t> periodFrames{};
+  std::atomic<std::int64_t> bufferFrames{};
+  std::atomic<std::int64_t> latencyNanoseconds{};
+  std::atomic<std::uint64_t> configurations{};
+  std::atomic<std::int64_t> periodBudgetNanoseconds{};
+  std::atomic<std::uint64_t> periodsWritten{};
+  std::atomic<std::uint64_t> xruns{};
+  std::atomic<std::int64_t> availFrames{};
+  std::atomic<std::int64_t> minimumAvailFrames{
+      std::numeric_limits<std::int64_t>::max()};
+  std::atomic<std::int64_t> maximumAvailFrames{};
+  std::atomic<std::int64_t> totalAvailFrames{};
+  std::atomic<std::int64_t> delayFrames{};
+  std::atomic<std::int64_t> minimumDelayFrames{
+      std::numeric_limits<std::int64_t>::max()};
+  std::atomic<std::int64_t> maximumDelayFrames{};
+  std::atomic<std::int64_t> totalDelayFrames{};
+  std::atomic<std::uint64_t> bufferLevelSamples{};
+  std::atomic<std::uint64_t> mixes{};
+  std::atomic<std::int64_t> mixNanoseconds{};
+  std::atomic<std::int64_t> maximumMixNanoseconds{};
+  std::atomic<std::int64_t> totalMixNanoseconds{};
+  std::atomic<std::uint64_t> mixesOverBudget{};
+  std::atomic<std::int64_t> wakeupJitterNanoseconds{};
+  std::atomic<std::int64_t> maximumWakeupJitterNanoseconds{};
+  std::atomic<std::int64_t> totalWakeupJitterNanoseconds{};
+  std::atomic<std::uint64_t> wakeups{};
+};
+
+void recordConfiguration(AudioStats &, std::int64_t periodFrames,
+                         std::int64_t bufferFrames, std::int64_t sampleRate);
+
+void recordMix(AudioStats &, std::chrono::nanoseconds);
+
+void recordWakeup(AudioStats &, std::chrono::nanoseconds sincePreviousWakeup);
+
+void recordBufferLevel(AudioStats &, std::int64_t availFrames,
+                       std::int64_t delayFrames);
+
+void recordPeriodWritten(AudioStats &);
+
+void recordXrun(AudioStats &);
+
+void dump(std::ostream &, const AudioStats &);
+} // namespace sbash64::game
+
+#endif
@@ -0,0 +1,104 @@
+#ifndef SBASH64_GAME_BAKED_LEVEL_HPP_
+#define SBASH64_GAME_BAKED_LEVEL_HPP_
+
+#include <sbash64/game/game.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <span>
+
+namespace sbash64::game {
+template <std::size_t N>
+constexpr auto hasPositiveSizes(const std::array<Rectangle, N> &solids)
+    -> bool {
+  return std::all_of(solids.begin(), solids.end(), [](Rectangle solid) {
+    return solid.width > 0 && solid.height > 0;
+  });
+}
+
+template <std::size_t N>
+constexpr auto noneOverlap(const std::array<Rectangle, N> &solids) -> bool {
+  for (std::size_t i{0}; i < N; ++i)
+    for (auto j{i + 1}; j < N; ++j)
+      if (overlaps(solids[i], solids[j]))
+        return false;
+  return true;
+}
+
+// Solids known when compiling, sorted and bucketed by bakeSolids as a
+// constant expression so that nothing is set up at run time. The columns
+// are sorted by left edge and split into buckets of equal width, so the
+// solids that can overlap a range of x are one contiguous run found in
+// constant time.
+template <std::size_t N, std::size_t Buckets> struct BakedSolids {
+  std::array<distance_type, N> left;
+  std::array<distance_type, N> top;
+  std::array<distance_type, N> right;
+  std::array<distance_type, N> bottom;
+  distance_type firstBucketLeft;
+  distance_type bucketWidth;
+  distance_type widest;
+  // The index of the first solid whose left edge is in each bucket or any
+  // later one.
+  std::array<std::size_t, Buckets + 1> bucketStarts;
+
+  [[nodiscard]] constexpr auto columns() const -> RectangleColumnsView {
+    return {left, top, right, bottom};
+  }
+
+  // A run of solids including every one that can overlap the region.
+  [[nodiscard]] constexpr auto near(Rectangle region) const
+      -> RectangleColumnsView {
+    const auto first{bucketStarts[bucket(leftEdge(region) - widest + 1)]};
+    const auto last{bucketStarts[std::min(bucket(rightEdge(region)) + 1,
+                                          Buckets)]};
+    const auto count{first < last ? last - first : 0};
+    return {std::span{left}.subspan(first, count),
+            std::span{top}.subspan(first, count),
+            std::span{right}.subspan(first, count),
+            std::span{bottom}.subspan(first, count)};
+  }
+
+  [[nodiscard]] constexpr auto bucket(distance_type x) const -> std::size_t {
+    if (x < firstBucketLeft)
+      return 0;
+    return std::min(static_cast<std::size_t>((x - firstBucketLeft) /
+                                             bucketWidth),
+                    Buckets - 1);
+  }
+};
+
+template <std::size_t Buckets = 16, std::size_t N>
+constexpr auto bakeSolids(std::array<Rectangle, N> solids)
+    -> BakedSolids<N, Buckets> {
+  static_assert(N > 0 && Buckets > 0);
+  BakedSolids<N, Buckets> baked{};
+  std::sort(solids.begin(), solids.end(), [](Rectangle a, Rectangle b) {
+    return leftEdge(a) < leftEdge(b);
+  });
+  baked.widest = 1;
+  for (std::size_t i{0}; i < N; ++i) {
+    const auto solid{solids[i]};
+    baked.left[i] = leftEdge(solid);
+    baked.top[i] = topEdge(solid);
+    baked.right[i] = rightEdge(solid);
+    baked.bottom[i] = bottomEdge(solid);
+    baked.widest = std::max(baked.widest, solid.width);
+  }
+  baked.firstBucketLeft = baked.left.front();
+  baked.bucketWidth =
+      (baked.left.back() - baked.left.front()) /
+          static_cast<distance_type>(Buckets) +
+      1;
+  std::size_t solid{0};
+  for (std::size_t b{0}; b <= Buckets; ++b) {
+    while (solid < N && baked.bucket(baked.left[solid]) < b)
+      ++solid;
+    baked.bucketStarts[b] = b == Buckets ? N : solid;
+  }
+  return baked;
+}
+} // namespace sbash64::game
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef SBASH64_GAME_BATCH_SIMULATION_HPP_
+#define SBASH64_GAME_BATCH_SIMULATION_HPP_
+
+#include <sbash64/game/contact-cache.hpp>
+#include <sbash64/game/game.hpp>
+#include <sbash64/game/thread-pool.hpp>
+#include <sbash64/game/tile-layer.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace sbash64::game {
+// Geometry and spawn points shared read-only by every instance.
+struct SimulationLevel {
+  TileLayer tiles;
+  RectangleColumns solids;
+  Rectangle floor;
+  Rectangle bounds;
+  Rectangle playerStart;
+  std::vector<Rectangle> enemyStarts;
+};
+
+struct SimulationPhysics {
+  RationalDistance gravity;
+  distance_type groundFriction;
+  distance_type playerMaxHorizontalSpeed;
+  distance_type playerJumpAcceleration;
+  distance_type playerRunAcceleration;
+  distance_type enemySpeed;
+};
+
+struct Observation {
+  Rectangle player;
+  Velocity velocity;
+  JumpState jumpState;
+  // From the player's origin to the nearest enemy's, or zero without enemies.
+  Point nearestEnemy;
+  bool touchingEnemy;
+};
+
+// Independent games stepped in lockstep for automated playtesting, without
+// rendering or audio. Each instance has a player and the level's enemies,
+// which walk toward the player. State is stored per kind of object across
+// all instances, and instances are stepped in chunks across a thread pool.
+class BatchSimulation {
+public:
+  // The level must outlive the simulation.
+  BatchSimulation(const SimulationLevel &, SimulationPhysics,
+                  std::size_t instances);
+
+  void reset(std::size_t instance);
+
+  // Advances every instance one tick with its input and writes what follows.
+  // Both spans hold one element per instance.
+  void step(std::span<const PlayerInput> inputs,
+            std::span<Observation> observations, ThreadPool &);
+
+  [[nodiscard]] auto instances() const -> std::size_t;
+  [[nodiscard]] auto ticks() const -> std::uint64_t;
+  [[nodiscard]] auto contactCacheCounts() const -> ContactCacheCounts;
+
+private:
+  void stepInstance(std::size_t instance, PlayerInput,
+                    Observation &, ContactCacheCounts &);
+
+  const SimulationLevel &level;
+  SimulationPhysics physics;
+  std::vector<PlayerState> players;
+  std::vector<ContactCache> playerContacts;
+  // Each instance's enemies are adjacent.
+  std::vector<PlayerState> enemies;
+  std::vector<ContactCache> enemyContacts;
+  std::vector<ContactCacheCounts> chunkCounts;
+  std::uint64_t tickCount{0};
+};
+} // namespace sbash64::game
+
+#endif
@@ -0,0 +1,159 @@
+#ifndef SBASH64_GAME_BEHAVIOURS_HPP_
+#define SBASH64_GAME_BEHAVIOURS_HPP_
+
+#include <sbash64/game/game.hpp>
+
+#include <coroutine>
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace sbash64::game {
+// Fixed-size blocks for coroutine frames, carved from one allocation so
+// that starting and finishing behaviours stays off the heap. Frames larger
+// than a block fall back to the heap and are counted.
+class FramePool {
+public:
+  FramePool(std::size_t blocks, std::size_t blockBytes);
+  // Each frame records its pool, so deallocate needs none.
+  static auto allocate(FramePool &, std::size_t bytes) -> void *;
+  static void deallocate(void *frame, std::size_t bytes);
+  [[nodiscard]] auto blocksInUse() const -> std::size_t;
+  [[nodiscard]] auto heapFallbacks() const -> std::size_t;
+
+private:
+  std::unique_ptr<std::byte[]> storage;
+  std::vector<std::byte *> freeBlocks;
+  std::size_t blockBytes;
+  std::size_t blocks;
+  std::size_t fallbacks{0};
+};
+
+// What a script knows about its entity and the player this tick, and what
+// it asks its entity to do.
+struct BehaviourView {
+  Rectangle self;
+  Rectangle player;
+  JumpState jumpState;
+  bool awake;
+  distance_type horizontalVelocity;
+  bool jump;
+};
+
+// A script resumed once per tick. Its first parameter is the pool its
+// frame is allocated from.
+class Behaviour {
+public:
+  struct promise_type {
+    template <typename... Parameters>
+    static auto operator new(std::size_t bytes, FramePool &pool,
+                             Parameters &...) -> void * {
+      return FramePool::allocate(pool, bytes);
+    }
+
+    static void operator delete(void *frame, std::size_t bytes) {
+      FramePool::deallocate(frame, bytes);
+    }
+
+    auto get_return_object() -> Behaviour {
+      return Behaviour{
+          std::coroutine_handle<promise_type>::from_promise(*this)};
+    }
+
+    static auto initial_suspend() noexcept -> std::suspend_always {
+      return {};
+    }
+
+    static auto final_suspend() noexcept -> std::suspend_always {
+      return {};
+    }
+
+    void return_void() {}
+
+    static void unhandled_exception() { throw; }
+  };
+
+  explicit Behaviour(std::coroutine_handle<promise_type>);
+  ~Behaviour();
+
+  Behaviour(Behaviour &&) noexcept;
+  auto operator=(Behaviour &&) noexcept -> Behaviour &;
+  Behaviour(const Behaviour &) = delete;
+  auto operator=(const Behaviour &) -> Behaviour & = delete;
+
+  void resume();
+  [[nodiscard]] auto done() const -> bool;
+
+private:
+  std::coroutine_handle<promise_type> handle;
+};
+
+// Suspends a script until the next tick.
+constexpr auto nextTick() -> std::suspend_always { return {}; }
+
+struct BehaviourKind {
+  std::size_t capacity;
+  // Enough for the frame of any script of the kind.
+  std::size_t frameBytes;
+};
+
+// Behaviours grouped by kind, each kind with a frame pool sized for its
+// scripts, and resumed a kind at a time so that each batch runs the same
+// code over neighbouring frames.
+class Behaviours {
+public:
+  explicit Behaviours(std::span<const BehaviourKind>);
+
+  // Starts script(pool, view, parameters...) and returns the view's id.
+  template <typename Script, typename... Parameters>
+  auto start(std::size_t kind, Script script, Parameters... parameters)
+      -> std::size_t {
+    if (views.size() == views.capacity())
+      throw std::runtime_error{"too many behaviours"};
+    const auto id{views.size()};
+    auto &view{views.emplace_back()};
+    auto &group{groups.at(kind)};
+    group.running.push_back({script(group.pool, view, parameters...), id});
+    return id;
+  }
+
+  auto view(std::size_t id) -> BehaviourView &;
+
+  // Resumes every unfinished behaviour whose entity is awake.
+  void tick();
+
+  [[nodiscard]] auto size() const -> std::size_t;
+  [[nodiscard]] auto blocksInUse() const -> std::size_t;
+  [[nodiscard]] auto heapFallbacks() const -> std::size_t;
+
+private:
+  struct Running {
+    Behaviour behaviour;
+    std::size_t view;
+  };
+
+  struct Group {
+    FramePool pool;
+    std::vector<Running> running;
+  };
+
+  std::vector<BehaviourView> views;
+  std::vector<Group> groups;
+};
+
+void dump(std::ostream &, const Behaviours &);
+
+// Walks back and forth between left and right until the player comes into
+// sight, stops for a moment, then chases and jumps after them until they
+// have been out of sight for a while.
+auto guard(FramePool &, BehaviourView &, distance_type left,
+           distance_type right) -> Behaviour;
+
+// Heads toward the player forever.
+auto chase(FramePool &, BehaviourView &) -> Behaviour;
+} // namespace sbash64::game
+
+#endif
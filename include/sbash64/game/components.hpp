@@ -0,0 +1,76 @@
+#ifndef SBASH64_GAME_COMPONENTS_HPP_
+#define SBASH64_GAME_COMPONENTS_HPP_
+
+#include <sbash64/game/contact-cache.hpp>
+#include <sbash64/game/entity-component-system.hpp>
+#include <sbash64/game/game.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace sbash64::game {
+struct Sprite {
+  Rectangle source;
+  std::size_t sheet;
+};
+
+struct KeyboardControlled {};
+
+// Moved by the behaviour with this id.
+struct Scripted {
+  std::size_t behaviour;
+};
+
+// Entities that are asleep are skipped by physics and AI until they wake.
+struct Activation {
+  bool awake{true};
+};
+
+// The animation for each state and the one playing, restarted on a switch.
+struct Animated {
+  std::uint32_t idle;
+  std::uint32_t moving;
+  std::uint32_t airborne;
+  std::uint32_t playing;
+  std::uint64_t since;
+};
+
+struct MovingCollider {
+  std::size_t proxy{std::numeric_limits<std::size_t>::max()};
+};
+
+using PlayerArchetype =
+    Archetype<Rectangle, Velocity, JumpState, DirectionFacing, Sprite,
+              KeyboardControlled, MovingCollider, ContactCache, Activation,
+              Animated>;
+
+using EnemyArchetype =
+    Archetype<Rectangle, Velocity, DirectionFacing, Sprite, Scripted,
+              MovingCollider, ContactCache, Activation, Animated>;
+
+using GameWorld = World<EnemyArchetype, PlayerArchetype>;
+
+constexpr auto playerState(const Rectangle &rectangle, const Velocity &velocity,
+                           JumpState jumpState,
+                           DirectionFacing directionFacing) -> PlayerState {
+  return {{rectangle, velocity}, jumpState, directionFacing};
+}
+
+constexpr void store(const PlayerState &playerState, Rectangle &rectangle,
+                     Velocity &velocity, JumpState &jumpState,
+                     DirectionFacing &directionFacing) {
+  rectangle = playerState.object.rectangle;
+  velocity = playerState.object.velocity;
+  jumpState = playerState.jumpState;
+  directionFacing = playerState.directionFacing;
+}
+
+constexpr void store(const MovingObject &object, Rectangle &rectangle,
+                     Velocity &velocity) {
+  rectangle = object.rectangle;
+  velocity = object.velocity;
+}
+} // namespace sbash64::game
+
+#endif
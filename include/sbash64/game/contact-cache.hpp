@@ -0,0 +1,46 @@
+#ifndef SBASH64_GAME_CONTACT_CACHE_HPP_
+#define SBASH64_GAME_CONTACT_CACHE_HPP_
+
+#include <sbash64/game/game.hpp>
+#include <sbash64/game/tile-layer.hpp>
+
+#include <cstddef>
+#include <optional>
+#include <ostream>
+
+namespace sbash64::game {
+// The surfaces an object stood on or pushed against last frame, valid for
+// one version of the static geometry.
+struct ContactCache {
+  std::optional<Rectangle> ground;
+  std::optional<Rectangle> rightWall;
+  std::optional<Rectangle> leftWall;
+  std::size_t geometryVersion{0};
+};
+
+struct ContactCacheCounts {
+  std::size_t hits;
+  std::size_t misses;
+};
+
+// Same as the TileLayer overloads, except that a cached contact still
+// touching the object is tried before searching all of the geometry. Bump
+// geometryVersion whenever the tiles or candidates change.
+auto handleVerticalCollisions(
+    PlayerState playerState, ContactCache &cache, ContactCacheCounts &counts,
+    std::size_t geometryVersion, const TileLayer &tiles,
+    RectangleColumnsView collisionFromBelowCandidates,
+    RectangleColumnsView collisionFromAboveCandidates,
+    const Rectangle &floorRectangle) -> PlayerState;
+
+auto handleHorizontalCollisions(
+    MovingObject object, ContactCache &cache, ContactCacheCounts &counts,
+    std::size_t geometryVersion, const TileLayer &tiles,
+    RectangleColumnsView collisionFromRightCandidates,
+    RectangleColumnsView collisionFromLeftCandidates,
+    const Rectangle &levelRectangle) -> MovingObject;
+
+void dump(std::ostream &, const ContactCacheCounts &);
+} // namespace sbash64::game
+
+#endif
@@ -0,0 +1,97 @@
+#ifndef SBASH64_GAME_CULLING_INDEX_HPP_
+#define SBASH64_GAME_CULLING_INDEX_HPP_
+
+#include <sbash64/game/components.hpp>
+#include <sbash64/game/game.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <ostream>
+#include <type_traits>
+#include <vector>
+
+namespace sbash64::game {
+struct Drawable {
+  Rectangle rectangle;
+  Sprite sprite;
+  DirectionFacing directionFacing;
+};
+
+struct CullingCounts {
+  std::size_t drawn;
+  std::size_t culled;
+};
+
+struct CullingStats {
+  std::size_t frames;
+  CullingCounts latest;
+  CullingCounts total;
+};
+
+// Rectangles of every entity with a sprite, sorted by left edge so that the
+// ones that can overlap the camera are a contiguous range found by binary
+// search. Only entities whose left edge changed are reordered, and they
+// move little between frames, so keeping the order costs one pass over the
+// rectangles.
+class CullingIndex {
+public:
+  // Refreshes the rectangles from the world.
+  void sync(GameWorld &);
+
+  // Calls f with each drawable overlapping the camera, in world order. The
+  // world must not have gained or lost drawables since sync.
+  template <typename F>
+  auto visible(GameWorld &world, Rectangle camera, F f) -> CullingCounts {
+    const auto first{std::lower_bound(
+        byLeftEdge.begin(), byLeftEdge.end(), leftEdge(camera) - widest + 1,
+        [](Entry entry, distance_type edge) { return entry.leftEdge < edge; })};
+    const auto last{std::upper_bound(
+        first, byLeftEdge.end(), rightEdge(camera),
+        [](distance_type edge, Entry entry) { return edge < entry.leftEdge; })};
+    visibleIds.clear();
+    for (auto entry{first}; entry != last; ++entry)
+      if (overlaps(rectangles[entry->id], camera))
+        visibleIds.push_back(entry->id);
+    std::sort(visibleIds.begin(), visibleIds.end());
+    std::size_t firstId{0};
+    auto next{visibleIds.begin()};
+    world.eachArchetype([&](auto &archetype) {
+      using A = std::remove_reference_t<decltype(archetype)>;
+      if constexpr (A::template has<Rectangle> && A::template has<Sprite> &&
+                    A::template has<DirectionFacing>) {
+        const auto endId{firstId + archetype.size()};
+        for (; next != visibleIds.end() && *next < endId; ++next) {
+          const auto row{*next - firstId};
+          f(Drawable{archetype.template column<Rectangle>()[row],
+                     archetype.template column<Sprite>()[row],
+                     archetype.template column<DirectionFacing>()[row]});
+        }
+        firstId = endId;
+      }
+    });
+    return {visibleIds.size(), rectangles.size() - visibleIds.size()};
+  }
+
+private:
+  struct Entry {
+    distance_type leftEdge;
+    std::size_t id;
+  };
+
+  void rebuild();
+  void swap(std::size_t, std::size_t);
+
+  std::vector<Rectangle> rectangles;
+  std::vector<Entry> byLeftEdge;
+  std::vector<std::size_t> position;
+  std::vector<std::size_t> moved;
+  std::vector<std::size_t> visibleIds;
+  distance_type widest{0};
+};
+
+void record(CullingStats &, CullingCounts);
+
+void dump(std::ostream &, const CullingStats &);
+} // namespace sbash64::game
+
+#endif
@@ -0,0 +1,111 @@
+#ifndef SBASH64_GAME_ENTITY_COMPONENT_SYSTEM_HPP_
+#define SBASH64_GAME_ENTITY_COMPONENT_SYSTEM_HPP_
+
+#include <cstddef>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace sbash64::game {
+// Every entity of an archetype has exactly the archetype's components, each
+// kind stored in its own contiguous column and indexed by row.
+template <typename... Components> class Archetype {
+public:
+  template <typename Component>
+  static constexpr auto has{(std::is_same_v<Component, Components> || ...)};
+
+  auto create(Components... components) -> std::size_t {
+    (std::get<std::vector<Components>>(columns).push_back(
+         std::move(components)),
+     ...);
+    return size() - 1;
+  }
+
+  void destroy(std::size_t row) {
+    (swapRemove(std::get<std::vector<Components>>(columns), row), ...);
+  }
+
+  void reserve(std::size_t rows) {
+    (std::get<std::vector<Components>>(columns).reserve(rows), ...);
+  }
+
+  [[nodiscard]] auto size() const -> std::size_t {
+    return std::get<0>(columns).size();
+  }
+
+  template <typename Component> auto column() -> std::span<Component> {
+    return std::get<std::vector<Component>>(columns);
+  }
+
+  template <typename Component>
+  [[nodiscard]] auto column() const -> std::span<const Component> {
+    return std::get<std::vector<Component>>(columns);
+  }
+
+private:
+  template <typename Component>
+  static void swapRemove(std::vector<Component> &column, std::size_t row) {
+    if (row + 1 != column.size())
+      column[row] = std::move(column.back());
+    column.pop_back();
+  }
+
+  std::tuple<std::vector<Components>...> columns;
+};
+
+template <typename... Archetypes> class World {
+public:
+  template <typename A> auto archetype() -> A & {
+    return std::get<A>(archetypes);
+  }
+
+  template <typename A> [[nodiscard]] auto archetype() const -> const A & {
+    return std::get<A>(archetypes);
+  }
+
+  template <typename F> void eachArchetype(F f) {
+    std::apply([&f](auto &...a) { (f(a), ...); }, archetypes);
+  }
+
+  // Calls f with references to the required components of every entity whose
+  // archetype has all of them, visiting archetypes in declaration order.
+  template <typename... Required, typename F> void each(F f) {
+    std::apply([&f](auto &...a) { (eachIn<Required...>(a, f), ...); },
+               archetypes);
+  }
+
+  template <typename... Required>
+  [[nodiscard]] auto count() const -> std::size_t {
+    std::size_t total{0};
+    std::apply(
+        [&total](const auto &...a) {
+          ((total += matches<std::decay_t<decltype(a)>, Required...>
+                         ? a.size()
+                         : 0),
+           ...);
+        },
+        archetypes);
+    return total;
+  }
+
+private:
+  template <typename A, typename... Required>
+  static constexpr auto matches{(A::template has<Required> && ...)};
+
+  template <typename... Required, typename A, typename F>
+  static void eachIn(A &a, F &f) {
+    if constexpr (matches<A, Required...>)
+      [&f](std::span<Required>... columns) {
+        const auto rows{std::get<0>(std::tie(columns...)).size()};
+        for (std::size_t row{0}; row < rows; ++row)
+          f(columns[row]...);
+      }(a.template column<Required>()...);
+  }
+
+  std::tuple<Archetypes...> archetypes;
+};
+} // namespace sbash64::game
+
+#endif
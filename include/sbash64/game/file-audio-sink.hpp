@@ -0,0 +1,35 @@
+#ifndef SBASH64_GAME_FILE_AUDIO_SINK_HPP_
+#define SBASH64_GAME_FILE_AUDIO_SINK_HPP_
+
+#include <sbash64/game/audio-sink.hpp>
+#include <sbash64/game/audio-stats.hpp>
+#include <sbash64/game/sndfile-wrappers.hpp>
+
+#include <cstdint>
+#include <span>
+#include <string>
+
+namespace sbash64::game {
+// Writes 16-bit WAV, consuming periods in real time. A failed write, such
+// as to a full disk, throws.
+class FileAudioSink : public AudioSink {
+public:
+  FileAudioSink(AudioStats &, const std::string &path, unsigned int sampleRate,
+                std::int64_t periodFrames);
+  void configure(std::int64_t periodFrames) override;
+  [[nodiscard]] auto periodFrames() const -> std::int64_t override;
+  void waitForPeriod() override;
+  [[nodiscard]] auto write(std::span<const short> interleavedPeriod)
+      -> bool override;
+
+private:
+  AudioStats &stats;
+  std::string path;
+  sndfile_wrappers::File file;
+  PeriodPacer pacer;
+  std::int64_t configuredPeriodFrames{};
+  unsigned int sampleRate;
+};
+} // namespace sbash64::game
+
+#endif
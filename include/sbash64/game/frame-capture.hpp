@@ -0,0 +1,79 @@
+#ifndef SBASH64_GAME_FRAME_CAPTURE_HPP_
+#define SBASH64_GAME_FRAME_CAPTURE_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <ostream>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace sbash64::game {
+// Appends a QOI image of the ARGB8888 pixels to encoded.
+void encodeQoi(std::span<const std::uint32_t> pixels, int width, int height,
+               std::vector<std::uint8_t> &encoded);
+
+struct CaptureBuffer {
+  std::vector<std::uint32_t> pixels;
+  std::uint64_t frame;
+};
+
+// Saves presented frames as <prefix>-<frame>.qoi. The render thread copies
+// each frame into one of a fixed set of buffers and hands it to workers
+// that encode and write it, so it only ever waits on a short lock. When
+// every buffer is still queued or being encoded, the frame is dropped.
+class FrameCapture {
+public:
+  FrameCapture(std::string prefix, int width, int height, std::size_t buffers,
+               std::size_t workers);
+  // Finishes the frames already handed over.
+  ~FrameCapture();
+  FrameCapture(const FrameCapture &) = delete;
+  auto operator=(const FrameCapture &) -> FrameCapture & = delete;
+  FrameCapture(FrameCapture &&) = delete;
+  auto operator=(FrameCapture &&) -> FrameCapture & = delete;
+
+  // A free buffer of width * height pixels, or nullptr after counting the
+  // frame as dropped.
+  auto acquire() -> CaptureBuffer *;
+  void submit(CaptureBuffer &);
+
+  [[nodiscard]] auto width() const -> int;
+  [[nodiscard]] auto height() const -> int;
+
+  struct Counts {
+    std::atomic<std::uint64_t> captured;
+    std::atomic<std::uint64_t> dropped;
+    std::atomic<std::uint64_t> written;
+    std::atomic<std::uint64_t> failed;
+    std::atomic<std::uint64_t> encodedBytes;
+    std::atomic<std::int64_t> encodeNanoseconds;
+  };
+  [[nodiscard]] auto counts() const -> const Counts &;
+
+private:
+  void work();
+
+  std::string prefix;
+  int imageWidth;
+  int imageHeight;
+  std::vector<CaptureBuffer> buffers;
+  std::vector<CaptureBuffer *> free;
+  std::deque<CaptureBuffer *> queued;
+  std::mutex mutex;
+  std::condition_variable ready;
+  bool stopping{false};
+  std::uint64_t frames{0};
+  Counts frameCounts{};
+  std::vector<std::thread> workers;
+};
+
+void dump(std::ostream &, const FrameCapture &);
+} // namespace sbash64::game
+
+#endif
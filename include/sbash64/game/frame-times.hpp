@@ -0,0 +1,23 @@
+#ifndef SBASH64_GAME_FRAME_TIMES_HPP_
+#define SBASH64_GAME_FRAME_TIMES_HPP_
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+
+namespace sbash64::game {
+// Owned by one thread; read by others only after joining it.
+struct FrameTimes {
+  std::uint64_t frames;
+  std::int64_t latestNanoseconds;
+  std::int64_t maximumNanoseconds;
+  std::int64_t totalNanoseconds;
+};
+
+void record(FrameTimes &, std::chrono::nanoseconds);
+
+void dump(std::ostream &, std::string_view name, const FrameTimes &);
+} // namespace sbash64::game
+
+#endif
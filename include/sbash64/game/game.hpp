@@ -2,12 +2,31 @@
 #define SBASH64_GAME_GAME_HPP_
 
 #include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <cstdlib>
 #include <limits>
+#include <optional>
+#include <span>
 #include <vector>
 
 namespace sbash64::game {
+// World coordinates are 64-bit when SBASH64_GAME_WIDE_DISTANCE is defined,
+// for levels too large for int. Products of two distances, as in the
+// cross-multiplied comparisons of RationalDistance, are computed with twice
+// the bits so that they cannot overflow.
+#ifdef SBASH64_GAME_WIDE_DISTANCE
+using distance_type = std::int64_t;
+__extension__ using distance_product_type = __int128;
+#else
 using distance_type = int;
+using distance_product_type = std::int64_t;
+#endif
+
+constexpr auto product(distance_type a, distance_type b)
+    -> distance_product_type {
+  return static_cast<distance_product_type>(a) * b;
+}
 
 constexpr auto isNegative(distance_type a) -> bool { return a < 0; }
 
@@ -39,8 +58,8 @@ constexpr auto operator+=(RationalDistance &a, RationalDistance b)
       else
         return a;
     } else {
-      a.numerator = a.numerator * commonDenominator / a.denominator +
-                    b.numerator * commonDenominator / b.denominator;
+      a.numerator = a.numerator * (commonDenominator / a.denominator) +
+                    b.numerator * (commonDenominator / b.denominator);
       a.denominator = commonDenominator;
       return a;
     }
@@ -79,8 +98,10 @@ constexpr auto operator/(RationalDistance a, distance_type b)
 
 constexpr auto operator<(RationalDistance a, RationalDistance b) -> bool {
   return (isNegative(a.denominator) ^ isNegative(b.denominator)) != 0
-             ? a.numerator * b.denominator > b.numerator * a.denominator
-             : a.numerator * b.denominator < b.numerator * a.denominator;
+             ? product(a.numerator, b.denominator) >
+                   product(b.numerator, a.denominator)
+             : product(a.numerator, b.denominator) <
+                   product(b.numerator, a.denominator);
 }
 
 constexpr auto operator>(RationalDistance a, RationalDistance b) -> bool {
@@ -96,13 +117,13 @@ constexpr auto operator>=(RationalDistance a, RationalDistance b) -> bool {
 }
 
 constexpr auto operator<(RationalDistance a, distance_type b) -> bool {
-  return isNegative(a.denominator) ? a.numerator > b * a.denominator
-                                   : a.numerator < b * a.denominator;
+  return isNegative(a.denominator) ? a.numerator > product(b, a.denominator)
+                                   : a.numerator < product(b, a.denominator);
 }
 
 constexpr auto operator>(RationalDistance a, distance_type b) -> bool {
-  return isNegative(a.denominator) ? a.numerator < b * a.denominator
-                                   : a.numerator > b * a.denominator;
+  return isNegative(a.denominator) ? a.numerator < product(b, a.denominator)
+                                   : a.numerator > product(b, a.denominator);
 }
 
 constexpr auto absoluteValue(distance_type a) -> distance_type {
@@ -180,6 +201,18 @@ constexpr auto bottomEdge(Rectangle a) -> distance_type {
   return a.origin.y + a.height - 1;
 }
 
+constexpr auto unite(Rectangle a, Rectangle b) -> Rectangle {
+  const auto left{std::min(leftEdge(a), leftEdge(b))};
+  const auto top{std::min(topEdge(a), topEdge(b))};
+  return {Point{left, top}, std::max(rightEdge(a), rightEdge(b)) - left + 1,
+          std::max(bottomEdge(a), bottomEdge(b)) - top + 1};
+}
+
+constexpr auto overlaps(Rectangle a, Rectangle b) -> bool {
+  return leftEdge(a) <= rightEdge(b) && leftEdge(b) <= rightEdge(a) &&
+         topEdge(a) <= bottomEdge(b) && topEdge(b) <= bottomEdge(a);
+}
+
 constexpr auto operator*=(Rectangle &a, distance_type scale) -> Rectangle & {
   a.origin.x *= scale;
   a.origin.y *= scale;
@@ -210,7 +243,7 @@ constexpr auto clamp(distance_type velocity, distance_type limit)
 constexpr auto withFriction(distance_type velocity, distance_type friction)
     -> distance_type {
   return (isNegative(velocity) ? -1 : 1) *
-         std::max(0, std::abs(velocity) - friction);
+         std::max(distance_type{0}, absoluteValue(velocity) - friction);
 }
 
 class CollisionDirection {
@@ -307,6 +340,14 @@ auto passesThrough(MovingObject movingObject,
                    const CollisionDirection &direction,
                    const CollisionAxis &axis) -> bool;
 
+// Stops the player on a surface whose top edge is ground.
+auto onPlayerHitGround(PlayerState playerState, distance_type ground)
+    -> PlayerState;
+
+// Stops the object against a wall so that its left edge is leftEdge.
+auto collideHorizontally(MovingObject object, distance_type leftEdge)
+    -> MovingObject;
+
 auto handleVerticalCollisions(
     PlayerState playerState,
     const std::vector<Rectangle> &collisionFromBelowCandidates,
@@ -319,12 +360,139 @@ auto handleHorizontalCollisions(
     const std::vector<Rectangle> &collisionFromLeftCandidates,
     const Rectangle &levelRectangle) -> MovingObject;
 
+void sortByTopEdge(std::span<Rectangle>);
+
+void sortByBottomEdge(std::span<Rectangle>);
+
+void sortByLeftEdge(std::span<Rectangle>);
+
+void sortByRightEdge(std::span<Rectangle>);
+
+// Same as handleVerticalCollisions but with candidates already sorted, so
+// nothing is copied or allocated.
+auto handleSortedVerticalCollisions(
+    PlayerState playerState,
+    std::span<const Rectangle> collisionFromBelowCandidatesSortedByTopEdge,
+    std::span<const Rectangle> collisionFromAboveCandidatesSortedByBottomEdge,
+    const Rectangle &floorRectangle) -> PlayerState;
+
+auto handleSortedHorizontalCollisions(
+    MovingObject object,
+    std::span<const Rectangle> collisionFromRightCandidatesSortedByLeftEdge,
+    std::span<const Rectangle> collisionFromLeftCandidatesSortedByRightEdge,
+    const Rectangle &levelRectangle) -> MovingObject;
+
+// Candidate rectangles stored as one column per edge.
+struct RectangleColumns {
+  std::vector<distance_type> left;
+  std::vector<distance_type> top;
+  std::vector<distance_type> right;
+  std::vector<distance_type> bottom;
+
+  void push_back(Rectangle a) {
+    left.push_back(leftEdge(a));
+    top.push_back(topEdge(a));
+    right.push_back(rightEdge(a));
+    bottom.push_back(bottomEdge(a));
+  }
+
+  [[nodiscard]] auto size() const -> std::size_t { return left.size(); }
+
+  [[nodiscard]] auto operator[](std::size_t i) const -> Rectangle {
+    return {Point{left[i], top[i]}, right[i] - left[i] + 1,
+            bottom[i] - top[i] + 1};
+  }
+};
+
+// Columns owned elsewhere, such as by RectangleColumns or a table baked at
+// compile time.
+struct RectangleColumnsView {
+  std::span<const distance_type> left;
+  std::span<const distance_type> top;
+  std::span<const distance_type> right;
+  std::span<const distance_type> bottom;
+
+  constexpr RectangleColumnsView(std::span<const distance_type> left,
+                                 std::span<const distance_type> top,
+                                 std::span<const distance_type> right,
+                                 std::span<const distance_type> bottom)
+      : left{left}, top{top}, right{right}, bottom{bottom} {}
+
+  RectangleColumnsView(const RectangleColumns &columns)
+      : left{columns.left}, top{columns.top}, right{columns.right},
+        bottom{columns.bottom} {}
+
+  [[nodiscard]] constexpr auto size() const -> std::size_t {
+    return left.size();
+  }
+
+  [[nodiscard]] constexpr auto operator[](std::size_t i) const -> Rectangle {
+    return {Point{left[i], top[i]}, right[i] - left[i] + 1,
+            bottom[i] - top[i] + 1};
+  }
+};
+
+enum class SweepDirection { fromBelow, fromAbove, fromRight, fromLeft };
+
+struct SweptHit {
+  std::size_t index;
+  RationalDistance timeOfImpact;
+  Point normal;
+};
+
+// Evaluates passesThrough against every candidate at once and returns the
+// candidate that the moving object reaches first, if any.
+auto earliestHit(MovingObject movingObject, RectangleColumnsView candidates,
+                 SweepDirection direction) -> std::optional<SweptHit>;
+
+// Same as the std::vector overloads, but the candidates are scanned where
+// they are without being sorted, so nothing is copied or allocated. These
+// are what the game calls each tick.
+auto handleVerticalCollisions(
+    PlayerState playerState,
+    RectangleColumnsView collisionFromBelowCandidates,
+    RectangleColumnsView collisionFromAboveCandidates,
+    const Rectangle &floorRectangle) -> PlayerState;
+
+auto handleHorizontalCollisions(
+    MovingObject object, RectangleColumnsView collisionFromRightCandidates,
+    RectangleColumnsView collisionFromLeftCandidates,
+    const Rectangle &levelRectangle) -> MovingObject;
+
 auto shiftBackground(Rectangle backgroundSourceRectangle,
                      distance_type backgroundSourceWidth,
                      const Rectangle &playerRectangle,
                      distance_type cameraWidth) -> Rectangle;
 
 auto applyVelocity(MovingObject object) -> MovingObject;
+
+// The controls held down during a tick.
+struct PlayerInput {
+  bool left;
+  bool right;
+  bool jump;
+};
+
+auto applyHorizontalForces(PlayerState playerState, PlayerInput input,
+                           distance_type groundFriction,
+                           distance_type playerMaxHorizontalSpeed,
+                           distance_type playerRunAcceleration) -> PlayerState;
+
+// Starts a jump when grounded and cuts it short once jump is released.
+auto applyVerticalForces(PlayerState playerState, PlayerInput input,
+                         distance_type playerJumpAcceleration,
+                         RationalDistance gravity) -> PlayerState;
+
+enum class MovingCollision { none, horizontal, firstLanded, secondLanded };
+
+struct MovingCollisionResult {
+  MovingObject first;
+  MovingObject second;
+  MovingCollision collision;
+};
+
+auto handleMovingCollision(MovingObject first, MovingObject second)
+    -> MovingCollisionResult;
 } // namespace sbash64::game
 
 #endif
@@ -0,0 +1,87 @@
+#ifndef SBASH64_GAME_INPUT_LATENCY_HPP_
+#define SBASH64_GAME_INPUT_LATENCY_HPP_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+namespace sbash64::game {
+struct InputEvent {
+  std::chrono::steady_clock::time_point time;
+  // The simulation tick that first sees the event.
+  std::uint64_t tick;
+};
+
+// Carries input events from the simulation thread to the render thread,
+// which measures their latency once a snapshot of their tick is presented.
+// One producer and one consumer, without locks.
+class InputEventQueue {
+public:
+  // Returns false, dropping the event, when the queue is full.
+  auto push(InputEvent event) -> bool {
+    const auto tail{this->tail.load(std::memory_order_relaxed)};
+    if (tail - head.load(std::memory_order_acquire) == events.size())
+      return false;
+    events[tail % events.size()] = event;
+    this->tail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Pops and passes to f every event seen by tick or earlier.
+  template <typename F> void drainThrough(std::uint64_t tick, F f) {
+    auto head{this->head.load(std::memory_order_relaxed)};
+    const auto tail{this->tail.load(std::memory_order_acquire)};
+    for (; head != tail && events[head % events.size()].tick <= tick; ++head)
+      f(events[head % events.size()]);
+    this->head.store(head, std::memory_order_release);
+  }
+
+private:
+  std::array<InputEvent, 256> events{};
+  std::atomic<std::size_t> head{0};
+  std::atomic<std::size_t> tail{0};
+};
+
+// Counts of latencies in 1 ms buckets, the last of which also holds
+// everything longer.
+struct LatencyHistogram {
+  std::array<std::uint64_t, 64> counts;
+  std::uint64_t samples;
+  std::int64_t maximumNanoseconds;
+  std::int64_t totalNanoseconds;
+};
+
+void record(LatencyHistogram &, std::chrono::nanoseconds);
+
+// One line per nonempty bucket.
+void dump(std::ostream &, const LatencyHistogram &);
+
+// Written by the render thread after each present so that the simulation
+// thread can aim its input sampling just ahead of the next frame.
+struct PresentSchedule {
+  std::atomic<std::int64_t> lastPresentNanoseconds{};
+  std::atomic<std::int64_t> periodNanoseconds{};
+  std::atomic<std::int64_t> drawNanoseconds{};
+};
+
+void recordPresent(PresentSchedule &, std::chrono::steady_clock::time_point,
+                   std::chrono::nanoseconds drawDuration);
+
+// When the render thread has to start drawing to make the next present,
+// less margin. Nothing is predicted until two presents have happened.
+auto nextDraw(const PresentSchedule &, std::chrono::nanoseconds margin)
+    -> std::chrono::steady_clock::time_point;
+
+// The period between presents, or zero when not yet known.
+auto presentPeriod(const PresentSchedule &) -> std::chrono::nanoseconds;
+
+// Mostly the longest recent duration, slowly forgetting old spikes.
+auto decayingMaximum(std::chrono::nanoseconds previous,
+                     std::chrono::nanoseconds latest)
+    -> std::chrono::nanoseconds;
+} // namespace sbash64::game
+
+#endif
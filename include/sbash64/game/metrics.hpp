@@ -0,0 +1,122 @@
+#ifndef SBASH64_GAME_METRICS_HPP_
+#define SBASH64_GAME_METRICS_HPP_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace sbash64::game {
+constexpr std::size_t maximumMetrics{64};
+constexpr std::size_t metricNameLength{40};
+constexpr std::size_t histogramBuckets{32};
+
+enum class MetricKind : std::uint32_t { counter, gauge, histogram };
+
+// A metric's value is the counter's total, the gauge's latest value or the
+// histogram's sum. Histogram bucket i counts values in [i, i + 1) times the
+// bucket width, with the last bucket also counting everything above.
+struct Metric {
+  std::array<char, metricNameLength> name;
+  MetricKind kind;
+  std::int64_t bucketWidth;
+  std::atomic<std::int64_t> value;
+  std::array<std::atomic<std::uint64_t>, histogramBuckets> buckets;
+};
+
+// Each metric has one writing thread, so updates are plain relaxed stores.
+class Counter {
+public:
+  explicit Counter(Metric &metric) : metric{&metric} {}
+  void add(std::int64_t amount = 1);
+
+private:
+  Metric *metric;
+};
+
+class Gauge {
+public:
+  explicit Gauge(Metric &metric) : metric{&metric} {}
+  void set(std::int64_t value);
+
+private:
+  Metric *metric;
+};
+
+class Histogram {
+public:
+  explicit Histogram(Metric &metric) : metric{&metric} {}
+  void record(std::int64_t value);
+
+private:
+  Metric *metric;
+};
+
+// The layout published in shared memory. sequence is odd while a snapshot is
+// being written, so readers retry until it is even and unchanged across
+// their copy.
+struct MetricsSegment {
+  std::array<char, 4> magic;
+  std::uint32_t version;
+  std::atomic<std::uint64_t> sequence;
+  std::atomic<std::uint64_t> metrics;
+  std::array<Metric, maximumMetrics> snapshot;
+};
+
+// Metrics updated in place by the threads that own them. Register every
+// metric before starting those threads.
+class MetricsRegistry {
+public:
+  auto counter(std::string_view name) -> Counter;
+  auto gauge(std::string_view name) -> Gauge;
+  auto histogram(std::string_view name, std::int64_t bucketWidth)
+      -> Histogram;
+
+  // Copies every metric into the segment as one consistent snapshot.
+  void publish(MetricsSegment &) const;
+
+private:
+  auto add(std::string_view name, MetricKind, std::int64_t bucketWidth)
+      -> Metric &;
+
+  std::array<Metric, maximumMetrics> metrics{};
+  std::size_t count{0};
+};
+
+// A POSIX shared memory object holding a MetricsSegment, created by the
+// game and removed when it exits, or opened read-only by a monitor.
+class SharedMetrics {
+public:
+  enum class Access { create, read };
+  SharedMetrics(const std::string &name, Access);
+  ~SharedMetrics();
+  SharedMetrics(const SharedMetrics &) = delete;
+  auto operator=(const SharedMetrics &) -> SharedMetrics & = delete;
+  SharedMetrics(SharedMetrics &&) = delete;
+  auto operator=(SharedMetrics &&) -> SharedMetrics & = delete;
+
+  [[nodiscard]] auto segment() const -> MetricsSegment &;
+
+private:
+  std::string name;
+  MetricsSegment *mapped;
+  Access access;
+};
+
+struct MetricValue {
+  std::array<char, metricNameLength> name;
+  MetricKind kind;
+  std::int64_t bucketWidth;
+  std::int64_t value;
+  std::array<std::uint64_t, histogramBuckets> buckets;
+};
+
+// Copies the latest consistent snapshot, returning how many metrics it has.
+// Throws if the writer does not finish publishing within about a second.
+auto read(const MetricsSegment &,
+          std::array<MetricValue, maximumMetrics> &values) -> std::size_t;
+} // namespace sbash64::game
+
+#endif
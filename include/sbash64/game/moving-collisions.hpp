@@ -0,0 +1,52 @@
+#ifndef SBASH64_GAME_MOVING_COLLISIONS_HPP_
+#define SBASH64_GAME_MOVING_COLLISIONS_HPP_
+
+#include <sbash64/game/aabb-tree.hpp>
+#include <sbash64/game/components.hpp>
+#include <sbash64/game/game.hpp>
+
+#include <cstddef>
+#include <ostream>
+#include <vector>
+
+namespace sbash64::game {
+struct MovingCollisionCounts {
+  std::size_t colliders;
+  std::size_t reinsertions;
+  std::size_t candidatePairs;
+  std::size_t collisions;
+};
+
+struct MovingCollisionStats {
+  std::size_t frames;
+  MovingCollisionCounts latest;
+  MovingCollisionCounts maximum;
+  MovingCollisionCounts total;
+};
+
+// Resolves collisions between entities with a MovingCollider that are
+// awake. Expected to run after collisions with static geometry and before
+// velocities are applied.
+class MovingCollisionSystem {
+public:
+  explicit MovingCollisionSystem(distance_type fatMargin);
+  [[nodiscard]] auto update(GameWorld &) -> MovingCollisionCounts;
+
+private:
+  struct Body {
+    Rectangle *rectangle;
+    Velocity *velocity;
+    JumpState *jumpState;
+  };
+
+  DynamicAabbTree tree;
+  std::vector<Body> bodies;
+  std::vector<CandidatePair> pairs;
+};
+
+void record(MovingCollisionStats &, MovingCollisionCounts);
+
+void dump(std::ostream &, const MovingCollisionStats &);
+} // namespace sbash64::game
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef SBASH64_GAME_PARALLAX_HPP_
+#define SBASH64_GAME_PARALLAX_HPP_
+
+#include <sbash64/game/game.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <vector>
+
+namespace sbash64::game {
+// A horizontally repeating background layer scrolled at a percentage of the
+// camera's speed. The image is split into strips one camera wide, and the
+// two strips under the view are kept composited side by side in a cache,
+// so that the layer is drawn with a single copy and the image is only read
+// again when the view crosses into another strip.
+class ParallaxLayer {
+public:
+  ParallaxLayer(distance_type imageWidth, distance_type height,
+                distance_type stripWidth, int scrollPercent);
+
+  // Calls composite(imageSource, cacheDestination) for each copy that
+  // brings the cache up to date, then returns the part of the cache to
+  // draw.
+  template <typename F>
+  auto view(distance_type cameraLeft, F composite) -> Rectangle {
+    const auto offset{scrollOffset(cameraLeft)};
+    const auto strip{stripOf(offset)};
+    if (cachedStrip != strip) {
+      auto x{imageColumn(strip * stripWidth)};
+      for (distance_type destination{0}; destination < cacheWidth();) {
+        const auto width{std::min(imageWidth - x, cacheWidth() - destination)};
+        composite(Rectangle{Point{x, 0}, width, height},
+                  Point{destination, 0});
+        destination += width;
+        x = 0;
+      }
+      cachedStrip = strip;
+    }
+    return {Point{offset - strip * stripWidth, 0}, stripWidth, height};
+  }
+
+  [[nodiscard]] auto cacheWidth() const -> distance_type;
+  [[nodiscard]] auto cacheHeight() const -> distance_type;
+
+private:
+  [[nodiscard]] auto scrollOffset(distance_type cameraLeft) const
+      -> distance_type;
+  [[nodiscard]] auto stripOf(distance_type offset) const -> distance_type;
+  [[nodiscard]] auto imageColumn(distance_type x) const -> distance_type;
+
+  distance_type imageWidth;
+  distance_type height;
+  distance_type stripWidth;
+  int scrollPercent;
+  std::optional<distance_type> cachedStrip;
+};
+
+struct ParallaxLayerStats {
+  std::uint64_t recomposites;
+  std::uint64_t compositedPixels;
+  std::uint64_t drawnPixels;
+  std::int64_t totalNanoseconds;
+};
+
+struct ParallaxStats {
+  std::uint64_t frames;
+  std::uint64_t screenPixels;
+  // Including the opaque background under the layers.
+  std::uint64_t drawnPixels;
+  std::vector<ParallaxLayerStats> layers;
+};
+
+void dump(std::ostream &, const ParallaxStats &);
+} // namespace sbash64::game
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef SBASH64_GAME_PARTICLES_HPP_
+#define SBASH64_GAME_PARTICLES_HPP_
+
+#include <sbash64/game/game.hpp>
+#include <sbash64/game/screen-space.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <vector>
+
+namespace sbash64::game {
+// Short-lived one pixel objects such as dust and debris, kept as parallel
+// arrays in a pool allocated once so that updating them is a few
+// vectorizable passes. Positions and velocities are in 1/256ths of a pixel,
+// and dead particles are replaced by the last live one.
+class ParticlePool {
+public:
+  explicit ParticlePool(std::size_t capacity);
+
+  // Returns false, dropping the particle, when the pool is full. The
+  // color indexes the palette of whoever draws the particles.
+  auto spawn(Point position, RationalDistance horizontalVelocity,
+             RationalDistance verticalVelocity, std::int32_t ticks,
+             std::uint8_t color) -> bool;
+
+  // Accelerates every particle by gravity, moves it and ages it one tick.
+  // Particles reaching the floor's top edge bounce back at half speed.
+  void update(RationalDistance gravity, std::optional<distance_type> floorTop);
+
+  // Appends each particle inside the camera, relative to it, to the list
+  // for its color.
+  void collect(Rectangle camera,
+               std::span<std::vector<ScreenRectangle>> byColor) const;
+
+  [[nodiscard]] auto live() const -> std::size_t;
+  [[nodiscard]] auto spawned() const -> std::uint64_t;
+  [[nodiscard]] auto dropped() const -> std::uint64_t;
+  [[nodiscard]] auto peak() const -> std::size_t;
+
+private:
+  std::vector<distance_type> x;
+  std::vector<distance_type> y;
+  std::vector<std::int32_t> horizontalVelocity;
+  std::vector<std::int32_t> verticalVelocity;
+  std::vector<std::int32_t> ticks;
+  std::vector<std::uint8_t> color;
+  std::size_t count{0};
+  std::size_t peakCount{0};
+  std::uint64_t spawnedCount{0};
+  std::uint64_t droppedCount{0};
+};
+
+void dump(std::ostream &, const ParticlePool &);
+} // namespace sbash64::game
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef SBASH64_GAME_PERFORMANCE_HUD_HPP_
+#define SBASH64_GAME_PERFORMANCE_HUD_HPP_
+
+#include <sbash64/game/screen-space.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sbash64::game {
+// In drawing order.
+enum class HudColor : std::uint8_t {
+  panel,
+  simulation,
+  render,
+  present,
+  frame,
+  overBudget,
+  text
+};
+
+constexpr std::size_t hudColors{7};
+
+struct HudFrame {
+  std::int64_t simulationNanoseconds;
+  std::int64_t renderNanoseconds;
+  std::int64_t presentNanoseconds;
+  std::int64_t frameNanoseconds;
+};
+
+struct HudCounters {
+  std::size_t entities;
+  std::size_t drawCalls;
+  std::int64_t audioFillPercent;
+  // What laying out and drawing the HUD took last frame.
+  std::int64_t hudNanoseconds;
+};
+
+using HudRectangles = std::array<std::vector<ScreenRectangle>, hudColors>;
+
+// An overlay of the latest frames' times as a rolling graph of stacked
+// simulation, render and present bars, with the latest numbers written
+// beside it in a 3x5 font. Frames are kept in a fixed ring, and the HUD is
+// laid out as rectangles grouped by color, so that drawing it takes one fill
+// call per color and allocates nothing once the groups have grown.
+class PerformanceHud {
+public:
+  static constexpr std::size_t history{120};
+
+  void record(HudFrame);
+
+  // Replaces rectangles with the HUD's, in screen pixels from origin.
+  void layout(const HudCounters &, ScreenPoint origin,
+              screen_distance_type scale, HudRectangles &rectangles) const;
+
+private:
+  std::array<HudFrame, history> frames{};
+  std::size_t next{0};
+  std::size_t recorded{0};
+};
+} // namespace sbash64::game
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef SBASH64_GAME_RENDER_SNAPSHOT_HPP_
+#define SBASH64_GAME_RENDER_SNAPSHOT_HPP_
+
+#include <sbash64/game/game.hpp>
+#include <sbash64/game/screen-space.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sbash64::game {
+struct SpriteDraw {
+  ScreenRectangle source;
+  // Relative to the camera.
+  ScreenRectangle destination;
+  std::size_t sheet;
+  bool flipped;
+};
+
+// Everything the render thread needs to draw one simulated frame.
+struct RenderSnapshot {
+  // Also where the background is drawn from.
+  Rectangle camera;
+  std::vector<SpriteDraw> sprites;
+  // One pixel particles relative to the camera, grouped by palette color so
+  // that each color is drawn with one call.
+  std::vector<std::vector<ScreenRectangle>> particles;
+  // The simulation tick that produced the snapshot.
+  std::uint64_t tick;
+  // For the performance HUD, which is drawn only when showHud is set.
+  std::int64_t simulationNanoseconds;
+  std::size_t entities;
+  bool showHud;
+};
+} // namespace sbash64::game
+
+#endif
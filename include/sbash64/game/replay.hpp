@@ -0,0 +1,42 @@
+#ifndef SBASH64_GAME_REPLAY_HPP_
+#define SBASH64_GAME_REPLAY_HPP_
+
+#include <sbash64/game/game.hpp>
+#include <sbash64/game/state-hash.hpp>
+
+#include <istream>
+#include <ostream>
+
+namespace sbash64::game {
+// The input sampled for a tick and the state hashes that followed it.
+struct ReplayTick {
+  PlayerInput input;
+  StateHashes hashes;
+};
+
+// Writes a little-endian stream beginning with "SBRP" and a version, then
+// one record per tick.
+class ReplayWriter {
+public:
+  explicit ReplayWriter(std::ostream &);
+  void write(const ReplayTick &);
+
+private:
+  std::ostream &stream;
+};
+
+class ReplayReader {
+public:
+  explicit ReplayReader(std::istream &);
+  // Returns false after the last tick, or at a tick cut off partway.
+  auto read(ReplayTick &) -> bool;
+  // Whether reading stopped at a tick cut off partway.
+  [[nodiscard]] auto truncated() const -> bool;
+
+private:
+  std::istream &stream;
+  bool endedPartway{false};
+};
+} // namespace sbash64::game
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef SBASH64_GAME_SCREEN_SPACE_HPP_
+#define SBASH64_GAME_SCREEN_SPACE_HPP_
+
+#include <sbash64/game/game.hpp>
+
+#include <cstdint>
+
+namespace sbash64::game {
+// Coordinates on screen or within a texture stay 32-bit however wide
+// distance_type is, since they are always small.
+using screen_distance_type = std::int32_t;
+
+struct ScreenPoint {
+  screen_distance_type x;
+  screen_distance_type y;
+};
+
+struct ScreenRectangle {
+  ScreenPoint origin;
+  screen_distance_type width;
+  screen_distance_type height;
+};
+
+// Subtracts in world coordinates before narrowing, so that rectangles near
+// the camera land exactly however far from the world's origin they are.
+constexpr auto relativeTo(Rectangle rectangle, Point origin)
+    -> ScreenRectangle {
+  return {{static_cast<screen_distance_type>(rectangle.origin.x - origin.x),
+           static_cast<screen_distance_type>(rectangle.origin.y - origin.y)},
+          static_cast<screen_distance_type>(rectangle.width),
+          static_cast<screen_distance_type>(rectangle.height)};
+}
+
+// For rectangles that are small to begin with, such as those within a
+// sprite sheet.
+constexpr auto narrow(Rectangle rectangle) -> ScreenRectangle {
+  return relativeTo(rectangle, Point{0, 0});
+}
+
+constexpr auto operator*(ScreenRectangle a, screen_distance_type scale)
+    -> ScreenRectangle {
+  return {{a.origin.x * scale, a.origin.y * scale},
+          a.width * scale,
+          a.height * scale};
+}
+} // namespace sbash64::game
+
+#endif
@@ -43,6 +43,8 @@ struct Renderer {
 
 struct Texture {
   Texture(SDL_Renderer *, SDL_Surface *);
+  // A blank render target.
+  Texture(SDL_Renderer *, int width, int height);
   ~Texture();
 
   Texture(Texture &&) = delete;
@@ -63,6 +65,19 @@ struct ImageInit {
   auto operator=(const ImageInit &) -> ImageInit & = delete;
 };
 
+// Owns a surface returned by SDL, throwing if it is null.
+struct Surface {
+  explicit Surface(SDL_Surface *);
+  ~Surface();
+
+  Surface(Surface &&) = delete;
+  auto operator=(Surface &&) -> Surface & = delete;
+  Surface(const Surface &) = delete;
+  auto operator=(const Surface &) -> Surface & = delete;
+
+  SDL_Surface *surface;
+};
+
 struct ImageSurface {
   explicit ImageSurface(const std::string &imagePath);
   ~ImageSurface();
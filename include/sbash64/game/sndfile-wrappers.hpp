@@ -8,6 +8,7 @@
 namespace sbash64::game::sndfile_wrappers {
 struct File {
   explicit File(const std::string &path);
+  File(const std::string &path, const SF_INFO &writeInfo);
   ~File();
 
   File(File &&) = delete;
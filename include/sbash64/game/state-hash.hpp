@@ -0,0 +1,59 @@
+#ifndef SBASH64_GAME_STATE_HASH_HPP_
+#define SBASH64_GAME_STATE_HASH_HPP_
+
+#include <sbash64/game/components.hpp>
+#include <sbash64/game/game.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace sbash64::game {
+// xxHash64 over a stream of 64-bit words. Its four lanes take alternate
+// words, so consecutive words do not wait on each other's multiplies.
+class StateHasher {
+public:
+  explicit StateHasher(std::uint64_t seed = 0);
+  void add(std::int64_t word);
+  [[nodiscard]] auto digest() const -> std::uint64_t;
+
+private:
+  std::array<std::uint64_t, 4> lanes;
+  std::array<std::uint64_t, 4> pending{};
+  std::size_t pendingWords{0};
+  std::uint64_t words{0};
+  std::uint64_t seed;
+};
+
+// One hash per field of the world state, in a fixed order, and a hash of
+// those. Values are widened to 64 bits first so that builds with either
+// distance_type agree.
+struct StateHashes {
+  std::vector<std::uint64_t> fields;
+  std::uint64_t combined;
+};
+
+// Hashes the rectangle, velocity, jump state and facing of every entity
+// with a velocity, then the camera, reusing the storage of hashes.
+void hashState(GameWorld &, Rectangle camera, StateHashes &hashes);
+
+// Such as "entity 1 velocity" or "camera".
+auto stateFieldName(std::size_t field, std::size_t fields) -> std::string;
+
+// The first field whose hash differs, counting a field that only one side
+// has as differing.
+auto firstDivergentField(const StateHashes &expected,
+                         const StateHashes &actual)
+    -> std::optional<std::size_t>;
+
+// Names the first divergent field, or the entity counts when the states
+// have different numbers of entities, which firstDivergentField cannot name.
+auto describeDivergence(const StateHashes &expected,
+                        const StateHashes &actual)
+    -> std::optional<std::string>;
+} // namespace sbash64::game
+
+#endif
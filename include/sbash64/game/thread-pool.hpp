@@ -0,0 +1,48 @@
+#ifndef SBASH64_GAME_THREAD_POOL_HPP_
+#define SBASH64_GAME_THREAD_POOL_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sbash64::game {
+// Workers that wait between batches instead of being started per batch. The
+// calling thread takes tasks too, so a pool of one thread has no workers.
+class ThreadPool {
+public:
+  explicit ThreadPool(std::size_t threads);
+  ~ThreadPool();
+  ThreadPool(const ThreadPool &) = delete;
+  auto operator=(const ThreadPool &) -> ThreadPool & = delete;
+  ThreadPool(ThreadPool &&) = delete;
+  auto operator=(ThreadPool &&) -> ThreadPool & = delete;
+
+  // Calls task(i) for every i below tasks, spread over the threads, and
+  // returns once all calls have. The task must not throw.
+  void run(std::size_t tasks, const std::function<void(std::size_t)> &task);
+
+  [[nodiscard]] auto threads() const -> std::size_t;
+
+private:
+  void work();
+  void takeTasks();
+
+  std::vector<std::thread> workers;
+  std::mutex mutex;
+  std::condition_variable started;
+  std::condition_variable finished;
+  const std::function<void(std::size_t)> *task{nullptr};
+  std::size_t tasks{0};
+  std::atomic<std::size_t> nextTask{0};
+  std::size_t busyWorkers{0};
+  std::uint64_t batch{0};
+  bool stopping{false};
+};
+} // namespace sbash64::game
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef SBASH64_GAME_TILE_LAYER_HPP_
+#define SBASH64_GAME_TILE_LAYER_HPP_
+
+#include <sbash64/game/game.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace sbash64::game {
+// Solid grid-aligned tiles stored twice as bits: one bitset per row for
+// ground and ceiling scans and one per column for wall scans, so that a
+// single word tests 64 tiles.
+class TileLayer {
+public:
+  TileLayer(Point origin, distance_type tileSize, std::size_t columns,
+            std::size_t rows);
+  void set(std::size_t column, std::size_t row, bool solid);
+  [[nodiscard]] auto solid(std::size_t column, std::size_t row) const -> bool;
+  // Marks every tile the rectangle overlaps as solid.
+  void fill(Rectangle);
+  [[nodiscard]] auto solidTiles() const -> std::size_t;
+  // Returns the run of adjacent solid tiles that passesThrough reports the
+  // moving object reaching first from the given direction, if any.
+  [[nodiscard]] auto firstSurface(MovingObject, SweepDirection) const
+      -> std::optional<Rectangle>;
+
+private:
+  [[nodiscard]] auto column(distance_type x) const -> distance_type;
+  [[nodiscard]] auto row(distance_type y) const -> distance_type;
+
+  std::vector<std::uint64_t> rowWords;
+  std::vector<std::uint64_t> columnWords;
+  Point origin;
+  distance_type tileSize;
+  std::size_t columns;
+  std::size_t rows;
+  std::size_t wordsPerRow;
+  std::size_t wordsPerColumn;
+};
+
+// The tile run or candidate that the moving object reaches first from the
+// given direction, if any.
+auto firstSurface(MovingObject, const TileLayer &, RectangleColumnsView,
+                  SweepDirection) -> std::optional<Rectangle>;
+
+// Same as the RectangleColumns overloads, with tiles checked alongside the
+// candidate rectangles.
+auto handleVerticalCollisions(
+    PlayerState playerState, const TileLayer &tiles,
+    RectangleColumnsView collisionFromBelowCandidates,
+    RectangleColumnsView collisionFromAboveCandidates,
+    const Rectangle &floorRectangle) -> PlayerState;
+
+auto handleHorizontalCollisions(
+    MovingObject object, const TileLayer &tiles,
+    RectangleColumnsView collisionFromRightCandidates,
+    RectangleColumnsView collisionFromLeftCandidates,
+    const Rectangle &levelRectangle) -> MovingObject;
+} // namespace sbash64::game
+
+#endif
@@ -0,0 +1,97 @@
+#ifndef SBASH64_GAME_TRIGGER_ZONES_HPP_
+#define SBASH64_GAME_TRIGGER_ZONES_HPP_
+
+#include <sbash64/game/game.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+namespace sbash64::game {
+enum class TriggerKind : std::uint8_t {
+  checkpoint,
+  killPlane,
+  musicCue,
+  spawner
+};
+
+// A region that reacts to objects entering and leaving it without
+// blocking them. What value means depends on the kind.
+struct TriggerZone {
+  Rectangle region;
+  TriggerKind kind;
+  std::uint32_t value;
+};
+
+struct TriggerEvent {
+  std::size_t zone;
+  bool entered;
+};
+
+// Zones fixed at level load, kept in a centered interval tree over their
+// horizontal extents. Each node holds the zones spanning its center sorted
+// both by left and by right edge, so a query visits O(log n) nodes and
+// stops scanning each at the first zone out of range. Zones found that way
+// are then checked vertically.
+class TriggerZones {
+public:
+  explicit TriggerZones(std::vector<TriggerZone>);
+
+  // Replaces zones with the indices of every zone overlapping the
+  // rectangle, in no particular order.
+  void overlapping(Rectangle, std::vector<std::size_t> &zones) const;
+
+  [[nodiscard]] auto zone(std::size_t) const -> const TriggerZone &;
+  [[nodiscard]] auto size() const -> std::size_t;
+
+private:
+  struct Entry {
+    distance_type left;
+    distance_type right;
+    distance_type top;
+    distance_type bottom;
+    std::size_t zone;
+  };
+
+  struct Node {
+    distance_type center;
+    std::size_t first;
+    std::size_t count;
+    std::size_t left;
+    std::size_t right;
+  };
+
+  auto build(std::vector<Entry> &entries) -> std::size_t;
+  void query(std::size_t node, Rectangle,
+             std::vector<std::size_t> &zones) const;
+
+  std::vector<TriggerZone> zones;
+  std::vector<Node> nodes;
+  std::vector<Entry> byLeft;
+  std::vector<Entry> byRight;
+  std::size_t root;
+};
+
+// The zones an object is inside, so that moving it can be reported as
+// entering and leaving zones.
+struct TriggerOccupancy {
+  std::vector<std::size_t> inside;
+  std::vector<std::size_t> overlapping;
+};
+
+struct TriggerStats {
+  std::uint64_t queries;
+  std::uint64_t entered;
+  std::uint64_t exited;
+};
+
+// Appends an event for each zone the rectangle entered or left since the
+// last update of this occupancy, exits first.
+void updateOccupancy(const TriggerZones &, TriggerOccupancy &, Rectangle,
+                     std::vector<TriggerEvent> &events, TriggerStats &);
+
+void dump(std::ostream &, const TriggerStats &);
+} // namespace sbash64::game
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef SBASH64_GAME_TRIPLE_BUFFER_HPP_
+#define SBASH64_GAME_TRIPLE_BUFFER_HPP_
+
+#include <array>
+#include <atomic>
+
+namespace sbash64::game {
+// Hands values from one writer thread to one reader thread without locks.
+// Each side owns one buffer and they trade through the third, so neither
+// ever waits for the other, and the reader always gets the newest value.
+template <typename T> class TripleBuffer {
+public:
+  // The writer's buffer, which may still hold an older value.
+  auto back() -> T & { return buffers[backIndex]; }
+
+  void publish() {
+    backIndex =
+        middle.exchange(backIndex | fresh, std::memory_order_acq_rel) & index;
+  }
+
+  // Returns whether a value published since the last call is now in front.
+  auto acquire() -> bool {
+    if ((middle.load(std::memory_order_relaxed) & fresh) == 0)
+      return false;
+    frontIndex = middle.exchange(frontIndex, std::memory_order_acq_rel) & index;
+    return true;
+  }
+
+  // The reader's buffer.
+  [[nodiscard]] auto front() const -> const T & { return buffers[frontIndex]; }
+
+private:
+  static constexpr unsigned index{3};
+  static constexpr unsigned fresh{4};
+
+  std::array<T, 3> buffers{};
+  std::atomic<unsigned> middle{1};
+  unsigned backIndex{0};
+  unsigned frontIndex{2};
+};
+} // namespace sbash64::game
+
+#endif
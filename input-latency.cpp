@@ -0,0 +1,98 @@
+#include <sbash64/game/input-latency.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+namespace sbash64::game {
+void record(LatencyHistogram &histogram, std::chrono::nanoseconds latency) {
+  const auto nanoseconds{static_cast<std::int64_t>(latency.count())};
+  const auto bucket{std::clamp<std::int64_t>(
+      std::chrono::duration_cast<std::chrono::milliseconds>(latency).count(),
+      0, static_cast<std::int64_t>(histogram.counts.size()) - 1)};
+  ++histogram.counts[static_cast<std::size_t>(bucket)];
+  ++histogram.samples;
+  histogram.maximumNanoseconds =
+      std::max(histogram.maximumNanoseconds, nanoseconds);
+  histogram.totalNanoseconds += nanoseconds;
+}
+
+void dump(std::ostream &stream, const LatencyHistogram &histogram) {
+  stream << "input to present latency us (mean/max): "
+         << (histogram.samples == 0
+                 ? 0
+                 : histogram.totalNanoseconds /
+                       static_cast<std::int64_t>(histogram.samples) / 1000)
+         << '/' << histogram.maximumNanoseconds / 1000 << '\n';
+  for (std::size_t bucket{0}; bucket < histogram.counts.size(); ++bucket)
+    if (histogram.counts[bucket] != 0) {
+      stream << "input to present latency " << bucket << '-';
+      if (bucket + 1 == histogram.counts.size())
+        stream << "inf";
+      else
+        stream << bucket + 1;
+      stream << " ms: " << histogram.counts[bucket] << '\n';
+    }
+}
+
+static auto sinceEpoch(std::chrono::steady_clock::time_point time)
+    -> std::int64_t {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             time.time_since_epoch())
+      .count();
+}
+
+void recordPresent(PresentSchedule &schedule,
+                   std::chrono::steady_clock::time_point present,
+                   std::chrono::nanoseconds drawDuration) {
+  const auto previous{
+      schedule.lastPresentNanoseconds.load(std::memory_order_relaxed)};
+  const auto now{sinceEpoch(present)};
+  if (previous != 0) {
+    const auto interval{now - previous};
+    const auto period{
+        schedule.periodNanoseconds.load(std::memory_order_relaxed)};
+    schedule.periodNanoseconds.store(
+        period == 0 ? interval : (7 * period + interval) / 8,
+        std::memory_order_relaxed);
+  }
+  schedule.drawNanoseconds.store(
+      decayingMaximum(
+          std::chrono::nanoseconds{
+              schedule.drawNanoseconds.load(std::memory_order_relaxed)},
+          drawDuration)
+          .count(),
+      std::memory_order_relaxed);
+  schedule.lastPresentNanoseconds.store(now, std::memory_order_release);
+}
+
+auto presentPeriod(const PresentSchedule &schedule)
+    -> std::chrono::nanoseconds {
+  return std::chrono::nanoseconds{
+      schedule.periodNanoseconds.load(std::memory_order_relaxed)};
+}
+
+auto nextDraw(const PresentSchedule &schedule, std::chrono::nanoseconds margin)
+    -> std::chrono::steady_clock::time_point {
+  const auto lastPresent{
+      schedule.lastPresentNanoseconds.load(std::memory_order_acquire)};
+  const auto period{presentPeriod(schedule)};
+  if (period.count() == 0)
+    return std::chrono::steady_clock::time_point{};
+  return std::chrono::steady_clock::time_point{
+             std::chrono::nanoseconds{lastPresent}} +
+         period -
+         std::chrono::nanoseconds{
+             schedule.drawNanoseconds.load(std::memory_order_relaxed)} -
+         margin;
+}
+
+auto decayingMaximum(std::chrono::nanoseconds previous,
+                     std::chrono::nanoseconds latest)
+    -> std::chrono::nanoseconds {
+  return std::max(latest, previous - previous / 64);
+}
+} // namespace sbash64::game
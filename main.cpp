@@ -1,27 +1,63 @@
 #include <algorithm>
 #include <array>
 #include <atomic>
+#include <charconv>
+#include <chrono>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
+#include <exception>
+#include <fstream>
 #include <functional>
 #include <iostream>
 #include <iterator>
 #include <limits>
+#include <memory>
+#include <optional>
 #include <span>
 #include <sstream>
 #include <stdexcept>
 #include <string>
 #include <string_view>
 #include <thread>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
-#include <sbash64/game/alsa-wrappers.hpp>
+#include <sbash64/game/activation.hpp>
+#include <sbash64/game/alsa-audio-sink.hpp>
+#include <sbash64/game/animation-table.hpp>
+#include <sbash64/game/audio-latency.hpp>
+#include <sbash64/game/audio-mixer.hpp>
+#include <sbash64/game/audio-sink.hpp>
+#include <sbash64/game/audio-stats.hpp>
+#include <sbash64/game/baked-level.hpp>
+#include <sbash64/game/behaviours.hpp>
+#include <sbash64/game/components.hpp>
+#include <sbash64/game/contact-cache.hpp>
+#include <sbash64/game/culling-index.hpp>
+#include <sbash64/game/entity-component-system.hpp>
+#include <sbash64/game/frame-times.hpp>
+#include <sbash64/game/file-audio-sink.hpp>
+#include <sbash64/game/frame-capture.hpp>
 #include <sbash64/game/game.hpp>
+#include <sbash64/game/input-latency.hpp>
+#include <sbash64/game/metrics.hpp>
+#include <sbash64/game/moving-collisions.hpp>
+#include <sbash64/game/parallax.hpp>
+#include <sbash64/game/particles.hpp>
+#include <sbash64/game/performance-hud.hpp>
+#include <sbash64/game/render-snapshot.hpp>
+#include <sbash64/game/replay.hpp>
+#include <sbash64/game/screen-space.hpp>
 #include <sbash64/game/sdl-wrappers.hpp>
 #include <sbash64/game/sndfile-wrappers.hpp>
+#include <sbash64/game/state-hash.hpp>
+#include <sbash64/game/tile-layer.hpp>
+#include <sbash64/game/trigger-zones.hpp>
+#include <sbash64/game/triple-buffer.hpp>
 
 #include <SDL.h>
 #include <SDL_events.h>
@@ -59,7 +95,9 @@ static auto getpixel(SDL_Surface *surface, int x, int y) -> Uint32 {
 }
 
 namespace sbash64::game {
-constexpr auto toSDLRect(Rectangle a) -> SDL_Rect {
+constexpr auto audioSampleRate{44100U};
+
+constexpr auto toSDLRect(ScreenRectangle a) -> SDL_Rect {
   SDL_Rect converted;
   converted.x = a.origin.x;
   converted.y = a.origin.y;
@@ -72,52 +110,17 @@ static auto pressing(const Uint8 *keyStates, SDL_Scancode code) -> bool {
   return keyStates[code] != 0U;
 }
 
-static auto applyHorizontalForces(PlayerState playerState,
-                                  distance_type groundFriction,
-                                  distance_type playerMaxHorizontalSpeed,
-                                  distance_type playerRunAcceleration)
-    -> PlayerState {
+static auto keyboardInput() -> PlayerInput {
   const auto *keyStates{SDL_GetKeyboardState(nullptr)};
-  if (pressing(keyStates, SDL_SCANCODE_LEFT)) {
-    playerState.object.velocity.horizontal -= playerRunAcceleration;
-    playerState.directionFacing = DirectionFacing::left;
-  }
-  if (pressing(keyStates, SDL_SCANCODE_RIGHT)) {
-    playerState.object.velocity.horizontal += playerRunAcceleration;
-    playerState.directionFacing = DirectionFacing::right;
-  }
-  playerState.object.velocity.horizontal = withFriction(
-      clamp(playerState.object.velocity.horizontal, playerMaxHorizontalSpeed),
-      groundFriction);
-  return playerState;
-}
-
-static auto applyVerticalForces(PlayerState playerState,
-                                distance_type playerJumpAcceleration,
-                                RationalDistance gravity,
-                                std::atomic<bool> &playJumpSound)
-    -> PlayerState {
-  const auto *keyStates{SDL_GetKeyboardState(nullptr)};
-  if (pressing(keyStates, SDL_SCANCODE_UP) &&
-      playerState.jumpState == JumpState::grounded) {
-    playerState.jumpState = JumpState::started;
-    playJumpSound = true;
-    playerState.object.velocity.vertical += playerJumpAcceleration;
-  }
-  playerState.object.velocity.vertical += gravity;
-  if (!pressing(keyStates, SDL_SCANCODE_UP) &&
-      playerState.jumpState == JumpState::started) {
-    playerState.jumpState = JumpState::released;
-    if (playerState.object.velocity.vertical < 0)
-      playerState.object.velocity.vertical = {0, 1};
-  }
-  return playerState;
+  return {pressing(keyStates, SDL_SCANCODE_LEFT),
+          pressing(keyStates, SDL_SCANCODE_RIGHT),
+          pressing(keyStates, SDL_SCANCODE_UP)};
 }
 
 static void present(const sdl_wrappers::Renderer &rendererWrapper,
                     const sdl_wrappers::Texture &textureWrapper,
-                    const Rectangle &sourceRectangle, int pixelScale,
-                    const Rectangle &destinationRectangle,
+                    const ScreenRectangle &sourceRectangle, int pixelScale,
+                    const ScreenRectangle &destinationRectangle,
                     SDL_RendererFlip flip = SDL_FLIP_NONE) {
   const auto projection{toSDLRect(destinationRectangle * pixelScale)};
   const auto sourceSDLRect{toSDLRect(sourceRectangle)};
@@ -125,196 +128,447 @@ static void present(const sdl_wrappers::Renderer &rendererWrapper,
                    &sourceSDLRect, &projection, 0, nullptr, flip);
 }
 
-static auto pollSdlEvents() -> bool {
+static auto area(Rectangle rectangle) -> std::uint64_t {
+  return static_cast<std::uint64_t>(rectangle.width * rectangle.height);
+}
+
+// Recomposites the layer's cache first if the camera entered another strip.
+// Returns the number of draw calls made.
+static auto drawParallaxLayer(const sdl_wrappers::Renderer &rendererWrapper,
+                              const sdl_wrappers::Texture &image,
+                              const sdl_wrappers::Texture &cache,
+                              ParallaxLayer &layer, distance_type cameraLeft,
+                              int pixelScale, ParallaxLayerStats &layerStats,
+                              ParallaxStats &stats) -> std::size_t {
+  const auto start{std::chrono::steady_clock::now()};
+  auto *renderer{rendererWrapper.renderer};
+  auto recomposited{false};
+  std::size_t drawCalls{1};
+  const auto source{layer.view(cameraLeft, [&](Rectangle imageSource,
+                                               Point cacheDestination) {
+    if (!recomposited) {
+      SDL_SetRenderTarget(renderer, cache.texture);
+      SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+      SDL_RenderClear(renderer);
+      ++layerStats.recomposites;
+      recomposited = true;
+    }
+    const auto sourceSDLRect{toSDLRect(narrow(imageSource))};
+    const auto destinationSDLRect{toSDLRect(
+        narrow({cacheDestination, imageSource.width, imageSource.height}))};
+    SDL_RenderCopy(renderer, image.texture, &sourceSDLRect,
+                   &destinationSDLRect);
+    ++drawCalls;
+    layerStats.compositedPixels += area(imageSource);
+  })};
+  if (recomposited)
+    SDL_SetRenderTarget(renderer, nullptr);
+  present(rendererWrapper, cache, narrow(source), pixelScale,
+          relativeTo(source, source.origin));
+  layerStats.drawnPixels += area(source);
+  stats.drawnPixels += area(source);
+  layerStats.totalNanoseconds +=
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - start)
+          .count();
+  return drawCalls;
+}
+
+// Dust, then sparks.
+constexpr std::array<SDL_Color, 2> particlePalette{
+    {{0xC8, 0xB4, 0x8C, 0xFF}, {0xFF, 0xE0, 0x40, 0xFF}}};
+
+// In the order of HudColor.
+constexpr std::array<SDL_Color, hudColors> hudPalette{
+    {{0x00, 0x00, 0x00, 0xC0},
+     {0x40, 0xC0, 0x40, 0xFF},
+     {0x40, 0x80, 0xFF, 0xFF},
+     {0xFF, 0xC0, 0x40, 0xFF},
+     {0xC0, 0xC0, 0xC0, 0xFF},
+     {0xFF, 0x40, 0x40, 0xFF},
+     {0xFF, 0xFF, 0xFF, 0xFF}}};
+
+// Slack left before the render thread's predicted draw when late latching.
+constexpr std::chrono::milliseconds lateLatchMargin{1};
+
+// The built-in level's solids, a block and a pipe standing on the floor.
+constexpr distance_type floorTop{208};
+constexpr std::array builtInSolids{
+    Rectangle{Point{256, 144}, 15, 15},
+    Rectangle{Point{448, floorTop - 40}, 30, 40}};
+static_assert(hasPositiveSizes(builtInSolids), "solids must not be empty");
+static_assert(noneOverlap(builtInSolids), "solids must not overlap");
+static_assert(std::none_of(builtInSolids.begin(), builtInSolids.end(),
+                           [](Rectangle solid) {
+                             return bottomEdge(solid) >= floorTop;
+                           }),
+              "solids must be above the floor");
+constexpr auto bakedSolids{bakeSolids(builtInSolids)};
+
+// The baked solids that an object can touch while moving, including those
+// just beside it.
+static auto solidsNear(MovingObject object) -> RectangleColumnsView {
+  const auto swept{unite(object.rectangle, applyVelocity(object).rectangle)};
+  return bakedSolids.near({Point{leftEdge(swept) - 1, topEdge(swept) - 1},
+                           swept.width + 2, swept.height + 2});
+}
+
+// Stops and joins a thread on leaving scope, so that an exception thrown
+// while the thread runs does not terminate the game.
+class ThreadStopper {
+public:
+  ThreadStopper(std::atomic<bool> &quit, std::thread &thread)
+      : quit{quit}, thread{thread} {}
+  ~ThreadStopper() { stop(); }
+
+  ThreadStopper(ThreadStopper &&) = delete;
+  auto operator=(ThreadStopper &&) -> ThreadStopper & = delete;
+  ThreadStopper(const ThreadStopper &) = delete;
+  auto operator=(const ThreadStopper &) -> ThreadStopper & = delete;
+
+  void stop() {
+    quit = true;
+    if (thread.joinable())
+      thread.join();
+  }
+
+private:
+  std::atomic<bool> &quit;
+  std::thread &thread;
+};
+
+// Draws the newest snapshot each frame. The renderer and textures are
+// created here because SDL rendering must stay on one thread, so an error
+// is kept in error for run to rethrow, and quit is set to stop the game.
+static void loopRendering(std::atomic<bool> &quit, std::exception_ptr &error,
+                          SDL_Window *window,
+                          SDL_Surface *backgroundSurface,
+                          std::vector<SDL_Surface *> spriteSheetSurfaces,
+                          int pixelScale,
+                          TripleBuffer<RenderSnapshot> &snapshots,
+                          FrameTimes &frameTimes, InputEventQueue &inputEvents,
+                          LatencyHistogram &inputLatency,
+                          PresentSchedule &presentSchedule, bool lateLatch,
+                          std::span<SDL_Surface *const> parallaxSurfaces,
+                          std::vector<ParallaxLayer> parallaxLayers,
+                          ParallaxStats &parallaxStats, Counter frames,
+                          Histogram frameMicroseconds, FrameCapture *capture,
+                          const AudioStats &audioStats,
+                          FrameTimes &hudTimes) try {
+  sdl_wrappers::Renderer rendererWrapper{window};
+  sdl_wrappers::Texture backgroundTextureWrapper{rendererWrapper.renderer,
+                                                 backgroundSurface};
+  std::vector<std::unique_ptr<sdl_wrappers::Texture>> spriteSheets;
+  for (auto *surface : spriteSheetSurfaces)
+    spriteSheets.push_back(std::make_unique<sdl_wrappers::Texture>(
+        rendererWrapper.renderer, surface));
+  std::vector<std::unique_ptr<sdl_wrappers::Texture>> parallaxImages;
+  std::vector<std::unique_ptr<sdl_wrappers::Texture>> parallaxCaches;
+  for (std::size_t i{0}; i < parallaxLayers.size(); ++i) {
+    parallaxImages.push_back(std::make_unique<sdl_wrappers::Texture>(
+        rendererWrapper.renderer, parallaxSurfaces[i]));
+    parallaxCaches.push_back(std::make_unique<sdl_wrappers::Texture>(
+        rendererWrapper.renderer, parallaxLayers[i].cacheWidth(),
+        parallaxLayers[i].cacheHeight()));
+  }
+  parallaxStats.layers.resize(parallaxLayers.size());
+  std::vector<SDL_Rect> particleRects;
+  PerformanceHud hud;
+  HudRectangles hudRectangles;
+  std::int64_t hudNanoseconds{0};
+  auto haveSnapshot{false};
+  auto previousPresent{std::chrono::steady_clock::now()};
+  while (!quit) {
+    if (lateLatch)
+      std::this_thread::sleep_until(
+          nextDraw(presentSchedule, lateLatchMargin));
+    haveSnapshot = snapshots.acquire() || haveSnapshot;
+    const auto drawStart{std::chrono::steady_clock::now()};
+    std::size_t drawCalls{0};
+    if (haveSnapshot) {
+      const auto &snapshot{snapshots.front()};
+      ++drawCalls;
+      present(rendererWrapper, backgroundTextureWrapper,
+              narrow(snapshot.camera), pixelScale,
+              relativeTo(snapshot.camera, snapshot.camera.origin));
+      const auto screenPixels{static_cast<std::uint64_t>(
+          snapshot.camera.width * snapshot.camera.height)};
+      ++parallaxStats.frames;
+      parallaxStats.screenPixels += screenPixels;
+      parallaxStats.drawnPixels += screenPixels;
+      for (std::size_t i{0}; i < parallaxLayers.size(); ++i)
+        drawCalls += drawParallaxLayer(
+            rendererWrapper, *parallaxImages[i], *parallaxCaches[i],
+            parallaxLayers[i], leftEdge(snapshot.camera), pixelScale,
+            parallaxStats.layers[i], parallaxStats);
+      drawCalls += snapshot.sprites.size();
+      for (const auto &sprite : snapshot.sprites)
+        present(rendererWrapper, *spriteSheets.at(sprite.sheet), sprite.source,
+                pixelScale, sprite.destination,
+                sprite.flipped ? SDL_FLIP_HORIZONTAL : SDL_FLIP_NONE);
+      for (std::size_t color{0}; color < snapshot.particles.size(); ++color) {
+        particleRects.clear();
+        for (const auto &particle : snapshot.particles[color])
+          particleRects.push_back(toSDLRect(particle * pixelScale));
+        const auto &rgba{particlePalette.at(color)};
+        SDL_SetRenderDrawColor(rendererWrapper.renderer, rgba.r, rgba.g,
+                               rgba.b, rgba.a);
+        SDL_RenderFillRects(rendererWrapper.renderer, particleRects.data(),
+                            static_cast<int>(particleRects.size()));
+        ++drawCalls;
+      }
+      // Drawn last, over the game, from the frames before this one.
+      if (snapshot.showHud) {
+        const auto hudStart{std::chrono::steady_clock::now()};
+        const auto bufferFrames{audioStats.bufferFrames.load()};
+        hud.layout({snapshot.entities, drawCalls,
+                    bufferFrames == 0 ? 0
+                                      : audioStats.delayFrames.load() * 100 /
+                                            bufferFrames,
+                    hudNanoseconds},
+                   {pixelScale, pixelScale}, pixelScale / 2, hudRectangles);
+        SDL_SetRenderDrawBlendMode(rendererWrapper.renderer,
+                                   SDL_BLENDMODE_BLEND);
+        for (std::size_t color{0}; color < hudColors; ++color) {
+          particleRects.clear();
+          for (const auto &rectangle : hudRectangles[color])
+            particleRects.push_back(toSDLRect(rectangle));
+          const auto &rgba{hudPalette[color]};
+          SDL_SetRenderDrawColor(rendererWrapper.renderer, rgba.r, rgba.g,
+                                 rgba.b, rgba.a);
+          SDL_RenderFillRects(rendererWrapper.renderer, particleRects.data(),
+                              static_cast<int>(particleRects.size()));
+        }
+        SDL_SetRenderDrawBlendMode(rendererWrapper.renderer,
+                                   SDL_BLENDMODE_NONE);
+        const auto hudTime{std::chrono::steady_clock::now() - hudStart};
+        record(hudTimes, hudTime);
+        hudNanoseconds =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(hudTime)
+                .count();
+      }
+    }
+    const auto drawEnd{std::chrono::steady_clock::now()};
+    if (capture != nullptr)
+      if (auto *buffer{capture->acquire()}) {
+        SDL_RenderReadPixels(rendererWrapper.renderer, nullptr,
+                             SDL_PIXELFORMAT_ARGB8888, buffer->pixels.data(),
+                             capture->width() * 4);
+        capture->submit(*buffer);
+      }
+    const auto presentStart{std::chrono::steady_clock::now()};
+    SDL_RenderPresent(rendererWrapper.renderer);
+    const auto now{std::chrono::steady_clock::now()};
+    if (haveSnapshot)
+      inputEvents.drainThrough(snapshots.front().tick,
+                               [&](const InputEvent &event) {
+                                 record(inputLatency, now - event.time);
+                               });
+    recordPresent(presentSchedule, now, drawEnd - drawStart);
+    record(frameTimes, now - previousPresent);
+    if (haveSnapshot) {
+      const auto nanoseconds{[](std::chrono::nanoseconds duration) {
+        return static_cast<std::int64_t>(duration.count());
+      }};
+      hud.record({snapshots.front().simulationNanoseconds,
+                  nanoseconds(drawEnd - drawStart),
+                  nanoseconds(now - presentStart),
+                  nanoseconds(now - previousPresent)});
+    }
+    frames.add();
+    frameMicroseconds.record(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            now - previousPresent)
+            .count());
+    previousPresent = now;
+  }
+} catch (...) {
+  error = std::current_exception();
+  quit = true;
+}
+
+// Key presses and releases are timestamped for measuring how long they take
+// to reach the screen. Events beyond the queue's capacity go unmeasured.
+// Pressing F3 shows or hides the performance HUD.
+static auto pollSdlEvents(InputEventQueue &inputEvents, std::uint64_t tick,
+                          bool &showHud) -> bool {
   SDL_Event event;
   while (SDL_PollEvent(&event) != 0)
     if (event.type == SDL_QUIT)
       return false;
+    else if (event.type == SDL_KEYDOWN && event.key.repeat == 0 &&
+             event.key.keysym.scancode == SDL_SCANCODE_F3)
+      showHud = !showHud;
+    else if ((event.type == SDL_KEYDOWN || event.type == SDL_KEYUP) &&
+             event.key.repeat == 0)
+      inputEvents.push(
+          {std::chrono::steady_clock::now() -
+               std::chrono::milliseconds{SDL_GetTicks() - event.key.timestamp},
+           tick});
   return true;
 }
 
-static auto applyVelocity(PlayerState playerState) -> PlayerState {
-  playerState.object = applyVelocity(playerState.object);
-  return playerState;
+// When to sample input next so that the tick finishes just before the render
+// thread starts drawing the following frame.
+static auto lateLatchTick(const PresentSchedule &presentSchedule,
+                          std::chrono::steady_clock::time_point previousTick,
+                          std::chrono::nanoseconds simulationBudget,
+                          std::chrono::nanoseconds fallbackTick)
+    -> std::chrono::steady_clock::time_point {
+  const auto period{presentPeriod(presentSchedule)};
+  if (period.count() == 0)
+    return previousTick + fallbackTick;
+  auto tick{nextDraw(presentSchedule,
+                     simulationBudget + 2 * lateLatchMargin)};
+  while (tick < previousTick + period / 2)
+    tick += period;
+  return tick;
 }
 
-static void throwAlsaRuntimeErrorOnFailure(const std::function<int()> &f,
-                                           std::string_view message) {
-  if (const auto error{f()}; error < 0)
-    throwAlsaRuntimeError(message, error);
+static auto readShortAudio(const std::string &path) -> std::vector<short> {
+  std::vector<short> audio;
+  sndfile_wrappers::File file{path};
+  audio.resize(static_cast<std::vector<short>::size_type>(file.info.frames *
+                                                          file.info.channels));
+  sf_readf_short(file.file, audio.data(), file.info.frames);
+  return audio;
 }
 
+// Mixes and writes periods until quitAudioThread is set. Like
+// loopRendering, an error such as from reconfiguring the sink is kept in
+// error for run to rethrow, and quitAudioThread is set to stop the game.
 static void loopAudio(std::atomic<bool> &quitAudioThread,
+                      std::exception_ptr &error,
                       std::atomic<bool> &playJumpSound,
                       const std::vector<short> &backgroundMusicData,
                       const std::vector<short> &jumpSoundData,
-                      const alsa_wrappers::PCM &pcm,
-                      std::vector<short> buffer) {
-  const auto periodSize{buffer.size() / 2};
-  std::ptrdiff_t backgroundMusicDataOffset{0};
-  std::ptrdiff_t jumpSoundDataOffset{0};
-  auto playingJumpSound{false};
+                      AudioSink &sink, const AudioLatencyTuning &latencyTuning,
+                      AudioStats &stats, Counter periodsWritten,
+                      Counter xruns) try {
+  auto tuner{afterConfigured(startTuning(latencyTuning), sink.periodFrames())};
+  std::vector<short> buffer(static_cast<std::vector<short>::size_type>(
+      audioChannels * tuner.periodFrames));
+  AudioMixer mixer{};
+  auto previousWakeup{std::chrono::steady_clock::now()};
 
   while (!quitAudioThread) {
+    const auto mixStart{std::chrono::steady_clock::now()};
     {
       auto expected{true};
-      if (!playingJumpSound &&
-          playJumpSound.compare_exchange_strong(expected, false)) {
-        playingJumpSound = true;
-        jumpSoundDataOffset = 0;
-      }
+      if (!mixer.playingJumpSound &&
+          playJumpSound.compare_exchange_strong(expected, false))
+        startJumpSound(mixer);
     }
+    mix(mixer, buffer, backgroundMusicData, jumpSoundData);
+    recordMix(stats, std::chrono::steady_clock::now() - mixStart);
 
-    if (backgroundMusicDataOffset + buffer.size() > backgroundMusicData.size())
-      backgroundMusicDataOffset = 0;
-
-    std::copy(backgroundMusicData.begin() + backgroundMusicDataOffset,
-              backgroundMusicData.begin() + backgroundMusicDataOffset +
-                  buffer.size(),
-              buffer.begin());
-
-    if (playingJumpSound) {
-      if (jumpSoundDataOffset + periodSize > jumpSoundData.size()) {
-        playingJumpSound = false;
-      } else {
-        auto counter{0};
-        for (auto &x : buffer)
-          x += jumpSoundData[jumpSoundDataOffset + counter++ / 2];
-      }
+    sink.waitForPeriod();
+    {
+      const auto wakeup{std::chrono::steady_clock::now()};
+      recordWakeup(stats, wakeup - previousWakeup);
+      previousWakeup = wakeup;
     }
 
-    throwAlsaRuntimeErrorOnFailure(
-        [&pcm]() { return snd_pcm_wait(pcm.pcm, -1); }, "wait failed");
-
-    if (const auto framesWritten{
-            snd_pcm_writei(pcm.pcm, buffer.data(), periodSize)};
-        framesWritten < 0)
-      throwAlsaRuntimeErrorOnFailure(
-          [&pcm, framesWritten]() {
-            return snd_pcm_recover(pcm.pcm, static_cast<int>(framesWritten), 0);
-          },
-          "recover failed");
-    else {
-      backgroundMusicDataOffset += 2 * periodSize;
-      if (playingJumpSound)
-        jumpSoundDataOffset += periodSize;
+    const auto previousPeriodFrames{tuner.periodFrames};
+    if (sink.write(buffer)) {
+      recordPeriodWritten(stats);
+      periodsWritten.add();
+      tuner = afterPeriodWritten(tuner, latencyTuning);
+      advance(mixer, previousPeriodFrames);
+    } else {
+      recordXrun(stats);
+      xruns.add();
+      tuner = afterXrun(tuner, latencyTuning);
+    }
+
+    if (tuner.periodFrames != previousPeriodFrames) {
+      sink.configure(tuner.periodFrames);
+      tuner = afterConfigured(tuner, sink.periodFrames());
+      buffer.resize(static_cast<std::vector<short>::size_type>(
+          audioChannels * tuner.periodFrames));
+      previousWakeup = std::chrono::steady_clock::now();
     }
   }
+} catch (...) {
+  error = std::current_exception();
+  quitAudioThread = true;
 }
 
-static auto readShortAudio(const std::string &path) -> std::vector<short> {
-  std::vector<short> audio;
-  sndfile_wrappers::File file{path};
-  audio.resize(static_cast<std::vector<short>::size_type>(file.info.frames *
-                                                          file.info.channels));
-  sf_readf_short(file.file, audio.data(), file.info.frames);
-  return audio;
+// Anything other than "alsa" or "null" is the path of a WAV file to write.
+static auto makeAudioSink(std::string_view name, AudioStats &stats,
+                          std::int64_t periodFrames)
+    -> std::unique_ptr<AudioSink> {
+  if (name == "alsa")
+    return std::make_unique<AlsaAudioSink>(stats, audioSampleRate,
+                                           periodFrames);
+  if (name == "null")
+    return std::make_unique<NullAudioSink>(stats, audioSampleRate,
+                                           periodFrames);
+  return std::make_unique<FileAudioSink>(stats, std::string{name},
+                                         audioSampleRate, periodFrames);
+}
+
+// Picks each awake entity's animation from its state and shows the frame
+// for the tick.
+static void animate(GameWorld &world, const AnimationTable &table,
+                    std::uint64_t tick) {
+  world.eachArchetype([&](auto &archetype) {
+    using A = std::remove_reference_t<decltype(archetype)>;
+    if constexpr (A::template has<Animated>) {
+      const auto velocities{archetype.template column<Velocity>()};
+      const auto activations{archetype.template column<Activation>()};
+      const auto animations{archetype.template column<Animated>()};
+      const auto sprites{archetype.template column<Sprite>()};
+      for (std::size_t row{0}; row < archetype.size(); ++row) {
+        if (!activations[row].awake)
+          continue;
+        auto &animated{animations[row]};
+        auto wanted{velocities[row].horizontal == 0 ? animated.idle
+                                                    : animated.moving};
+        if constexpr (A::template has<JumpState>)
+          if (archetype.template column<JumpState>()[row] !=
+              JumpState::grounded)
+            wanted = animated.airborne;
+        if (wanted != animated.playing) {
+          animated.playing = wanted;
+          animated.since = tick;
+        }
+        sprites[row] = table.sprite(animated.playing, tick - animated.since);
+      }
+    }
+  });
 }
 
-static auto initializeAlsaPcm(snd_pcm_uframes_t periodSize)
-    -> alsa_wrappers::PCM {
-  alsa_wrappers::PCM pcm;
-  snd_pcm_hw_params_t *hw_params = nullptr;
-  throwAlsaRuntimeErrorOnFailure(
-      [&hw_params]() { return snd_pcm_hw_params_malloc(&hw_params); },
-      "cannot allocate hardware parameter structure");
-  throwAlsaRuntimeErrorOnFailure(
-      [&pcm, hw_params]() { return snd_pcm_hw_params_any(pcm.pcm, hw_params); },
-      "cannot initialize hardware parameter structure");
-  throwAlsaRuntimeErrorOnFailure(
-      [&pcm, hw_params]() {
-        return snd_pcm_hw_params_set_access(pcm.pcm, hw_params,
-                                            SND_PCM_ACCESS_RW_INTERLEAVED);
-      },
-      "cannot set access type");
-  throwAlsaRuntimeErrorOnFailure(
-      [&pcm, hw_params]() {
-        return snd_pcm_hw_params_set_format(pcm.pcm, hw_params,
-                                            SND_PCM_FORMAT_S16);
-      },
-      "cannot set sample format");
-  throwAlsaRuntimeErrorOnFailure(
-      [&pcm, hw_params]() {
-        auto desiredSampleRate{44100U};
-        auto direction{0};
-        return snd_pcm_hw_params_set_rate_near(pcm.pcm, hw_params,
-                                               &desiredSampleRate, &direction);
-      },
-      "cannot set sample rate");
-  throwAlsaRuntimeErrorOnFailure(
-      [&pcm, hw_params, periodSize]() {
-        snd_pcm_uframes_t desiredPeriodSize{periodSize};
-        auto direction{0};
-        return snd_pcm_hw_params_set_period_size(pcm.pcm, hw_params,
-                                                 desiredPeriodSize, direction);
-      },
-      "cannot set period size");
-  unsigned int periods{2};
-  throwAlsaRuntimeErrorOnFailure(
-      [&pcm, hw_params, &periods]() {
-        auto direction{0};
-        return snd_pcm_hw_params_set_periods_near(pcm.pcm, hw_params, &periods,
-                                                  &direction);
-      },
-      "cannot set periods");
-  snd_pcm_uframes_t bufferSize{periods * periodSize};
-  throwAlsaRuntimeErrorOnFailure(
-      [&pcm, hw_params, &bufferSize]() {
-        return snd_pcm_hw_params_set_buffer_size_near(pcm.pcm, hw_params,
-                                                      &bufferSize);
-      },
-      "cannot set buffer size");
-  throwAlsaRuntimeErrorOnFailure(
-      [&pcm, hw_params]() {
-        return snd_pcm_hw_params_set_channels(pcm.pcm, hw_params, 2);
-      },
-      "cannot set channel count");
-  throwAlsaRuntimeErrorOnFailure(
-      [&pcm, hw_params]() { return snd_pcm_hw_params(pcm.pcm, hw_params); },
-      "cannot set parameters");
-  snd_pcm_hw_params_free(hw_params);
-
-  snd_pcm_sw_params_t *sw_params = nullptr;
-  throwAlsaRuntimeErrorOnFailure(
-      [&sw_params]() { return snd_pcm_sw_params_malloc(&sw_params); },
-      "cannot allocate software parameters structure");
-  throwAlsaRuntimeErrorOnFailure(
-      [&pcm, sw_params]() {
-        return snd_pcm_sw_params_current(pcm.pcm, sw_params);
-      },
-      "cannot initialize software parameters structure");
-  throwAlsaRuntimeErrorOnFailure(
-      [&pcm, sw_params, periodSize]() {
-        return snd_pcm_sw_params_set_avail_min(pcm.pcm, sw_params, periodSize);
-      },
-      "cannot set minimum available count");
-  throwAlsaRuntimeErrorOnFailure(
-      [&pcm, sw_params, bufferSize, periodSize]() {
-        return snd_pcm_sw_params_set_start_threshold(
-            pcm.pcm, sw_params, (bufferSize / periodSize) * periodSize);
-      },
-      "cannot set start threshold");
-  throwAlsaRuntimeErrorOnFailure(
-      [&pcm, sw_params]() { return snd_pcm_sw_params(pcm.pcm, sw_params); },
-      "cannot set software parameters");
-
-  snd_output_t *debugOutput{};
-  throwAlsaRuntimeErrorOnFailure(
-      [&debugOutput]() {
-        return snd_output_stdio_attach(&debugOutput, stdout, 0);
-      },
-      "cannot initialize stdio output");
-  snd_pcm_dump(pcm.pcm, debugOutput);
-  snd_output_close(debugOutput);
-
-  return pcm;
+static void spawnLandingDust(ParticlePool &particles,
+                             const Rectangle &landed) {
+  constexpr auto puffs{12};
+  for (auto i{0}; i < puffs; ++i)
+    particles.spawn(
+        Point{leftEdge(landed) + i * landed.width / puffs, bottomEdge(landed)},
+        RationalDistance{i - puffs / 2, 4}, RationalDistance{-1 - i % 3, 2},
+        20 + i % 4, 0);
 }
 
+struct ParallaxLayerImage {
+  std::string path;
+  int scrollPercent;
+};
+
 static auto run(const std::string &playerImagePath,
                 const std::string &backgroundImagePath,
                 const std::string &enemyImagePath,
                 const std::string &backgroundMusicPath,
-                const std::string &jumpSoundPath) -> int {
+                const std::string &jumpSoundPath,
+                const AudioLatencyTuning &audioLatencyTuning,
+                std::string_view audioSinkName,
+                distance_type activationMargin, bool lateLatch,
+                std::span<const ParallaxLayerImage> parallaxLayerImages,
+                std::optional<std::string_view> animationTablePath,
+                std::optional<std::string_view> atlasPrefix,
+                std::optional<std::string_view> recordPath,
+                std::optional<std::string_view> replayPath,
+                std::optional<std::string_view> metricsName,
+                std::optional<std::string_view> capturePrefix) -> int {
   sdl_wrappers::Init sdlInitialization;
   constexpr auto pixelScale{4};
   const auto cameraWidth{256};
@@ -322,7 +576,6 @@ static auto run(const std::string &playerImagePath,
   constexpr auto screenWidth{cameraWidth * pixelScale};
   constexpr auto screenHeight{cameraHeight * pixelScale};
   sdl_wrappers::Window windowWrapper{screenWidth, screenHeight};
-  sdl_wrappers::Renderer rendererWrapper{windowWrapper.window};
   SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "1");
   sdl_wrappers::ImageInit sdlImageInitialization;
   sdl_wrappers::ImageSurface playerImageSurfaceWrapper{playerImagePath};
@@ -339,14 +592,23 @@ static auto run(const std::string &playerImagePath,
   const auto enemyWidth{16};
   const auto enemyHeight{16};
   const Rectangle enemySourceRect{Point{1, 28}, enemyWidth, enemyHeight};
-  sdl_wrappers::Texture playerTextureWrapper{rendererWrapper.renderer,
-                                             playerImageSurfaceWrapper.surface};
-  sdl_wrappers::Texture backgroundTextureWrapper{
-      rendererWrapper.renderer, backgroundImageSurfaceWrapper.surface};
-  sdl_wrappers::Texture enemyTextureWrapper{rendererWrapper.renderer,
-                                            enemyImageSurfaceWrapper.surface};
-  const Rectangle floorRectangle{Point{0, cameraHeight - 32},
-                                 backgroundSourceWidth, 32};
+  // Layers are drawn over the background in order, keyed on their top left
+  // pixel.
+  std::vector<std::unique_ptr<sdl_wrappers::ImageSurface>>
+      parallaxSurfaceWrappers;
+  std::vector<SDL_Surface *> parallaxSurfaces;
+  std::vector<ParallaxLayer> parallaxLayers;
+  for (const auto &layerImage : parallaxLayerImages) {
+    parallaxSurfaceWrappers.push_back(
+        std::make_unique<sdl_wrappers::ImageSurface>(layerImage.path));
+    auto *surface{parallaxSurfaceWrappers.back()->surface};
+    SDL_SetColorKey(surface, SDL_TRUE, getpixel(surface, 0, 0));
+    parallaxSurfaces.push_back(surface);
+    parallaxLayers.emplace_back(surface->w, std::min(surface->h, cameraHeight),
+                                cameraWidth, layerImage.scrollPercent);
+  }
+  const Rectangle floorRectangle{Point{0, floorTop}, backgroundSourceWidth,
+                                 cameraHeight - floorTop};
   const Rectangle levelRectangle{Point{-1, -1}, backgroundSourceWidth + 1,
                                  cameraHeight + 1};
   const RationalDistance gravity{1, 4};
@@ -354,81 +616,535 @@ static auto run(const std::string &playerImagePath,
   const auto playerMaxHorizontalSpeed{4};
   const auto playerJumpAcceleration{-6};
   const auto playerRunAcceleration{2};
-  PlayerState playerState{
-      {Rectangle{Point{0, topEdge(floorRectangle) - playerHeight}, playerWidth,
-                 playerHeight},
-       Velocity{{0, 1}, 0}},
-      JumpState::grounded,
-      DirectionFacing::right};
-  MovingObject enemy{{Point{140, topEdge(floorRectangle) - enemyHeight},
-                      enemyWidth, enemyHeight},
-                     Velocity{{0, 1}, 0}};
-  const Rectangle blockRectangle{Point{256, 144}, 15, 15};
-  const auto pipeHeight{40};
-  const Rectangle pipeRectangle{
-      Point{448, topEdge(floorRectangle) - pipeHeight}, 30, pipeHeight};
+  // With --animations=<table> and --atlas=<prefix>, sprites come from the
+  // <prefix>-<n>.png atlases written by sbash64-game-pack-atlas instead of
+  // the player and enemy sheets.
+  std::optional<AnimationTable> animationTable;
+  std::vector<std::unique_ptr<sdl_wrappers::ImageSurface>> atlasWrappers;
+  std::vector<SDL_Surface *> spriteSheetSurfaces{
+      playerImageSurfaceWrapper.surface, enemyImageSurfaceWrapper.surface};
+  Animated playerAnimations{};
+  Animated enemyAnimations{};
+  if (animationTablePath.has_value() != atlasPrefix.has_value())
+    throw std::runtime_error{"--animations and --atlas go together"};
+  if (animationTablePath) {
+    std::ifstream stream{std::string{*animationTablePath}, std::ios::binary};
+    if (!stream)
+      throw std::runtime_error{"unable to open " +
+                               std::string{*animationTablePath}};
+    animationTable.emplace(stream);
+    spriteSheetSurfaces.clear();
+    for (std::size_t i{0}; i < animationTable->atlases(); ++i) {
+      atlasWrappers.push_back(std::make_unique<sdl_wrappers::ImageSurface>(
+          std::string{*atlasPrefix} + '-' + std::to_string(i) + ".png"));
+      spriteSheetSurfaces.push_back(atlasWrappers.back()->surface);
+    }
+    const auto playerIdle{animationTable->find("player-idle")};
+    playerAnimations = {playerIdle, animationTable->find("player-run"),
+                        animationTable->find("player-jump"), playerIdle, 0};
+    const auto enemyWalk{animationTable->find("enemy-walk")};
+    enemyAnimations = {enemyWalk, enemyWalk, enemyWalk, enemyWalk, 0};
+  }
+  // Scripts of a kind share a frame pool and are resumed together.
+  constexpr std::size_t guardBehaviours{0};
+  constexpr std::array<BehaviourKind, 1> behaviourKinds{{{1024, 128}}};
+  Behaviours behaviours{behaviourKinds};
+  GameWorld world;
+  world.archetype<PlayerArchetype>().create(
+      Rectangle{Point{0, topEdge(floorRectangle) - playerHeight}, playerWidth,
+                playerHeight},
+      Velocity{{0, 1}, 0}, JumpState::grounded, DirectionFacing::right,
+      Sprite{playerSourceRect, 0}, KeyboardControlled{}, MovingCollider{},
+      ContactCache{}, Activation{}, playerAnimations);
+  // A guard standing on the floor at left, patrolling patrolWidth to its
+  // right.
+  const auto spawnGuard{[&](distance_type left, distance_type patrolWidth) {
+    world.archetype<EnemyArchetype>().create(
+        Rectangle{Point{left, topEdge(floorRectangle) - enemyHeight},
+                  enemyWidth, enemyHeight},
+        Velocity{{0, 1}, 0}, DirectionFacing::right,
+        Sprite{enemySourceRect, 1},
+        Scripted{behaviours.start(guardBehaviours, guard, left,
+                                  left + patrolWidth)},
+        MovingCollider{}, ContactCache{}, Activation{}, enemyAnimations);
+  }};
+  spawnGuard(140, 80);
+  MovingCollisionSystem movingCollisionSystem{4};
   Rectangle backgroundSourceRectangle{Point{0, 0}, cameraWidth, cameraHeight};
+  // Checkpoints span the level's height at their left edge, and the player
+  // respawns there when touching a kill plane. Spawners start a guard half
+  // a camera to their right, patrolling value pixels, once.
+  const TriggerZones triggerZones{{
+      {Rectangle{Point{0, 0}, 32, topEdge(floorRectangle)},
+       TriggerKind::checkpoint, 0},
+      {Rectangle{Point{496, 0}, 32, topEdge(floorRectangle)},
+       TriggerKind::checkpoint, 0},
+      {Rectangle{Point{560, 0}, 32, topEdge(floorRectangle)},
+       TriggerKind::spawner, 120},
+      {Rectangle{Point{leftEdge(levelRectangle),
+                       bottomEdge(floorRectangle) + 1},
+                 levelRectangle.width, 1},
+       TriggerKind::killPlane, 0},
+  }};
+  std::vector<bool> spawnersUsed(triggerZones.size());
+  TriggerOccupancy playerTriggers;
+  std::vector<TriggerEvent> triggerEvents;
+  TriggerStats triggerStats{};
+  Point checkpoint{0, topEdge(floorRectangle) - playerHeight};
+
+  // With --metrics=<name>, metrics are published each tick to the POSIX
+  // shared memory object of that name for sbash64-game-metrics to print.
+  MetricsRegistry metrics;
+  auto ticksCounter{metrics.counter("ticks")};
+  auto simulationMicroseconds{metrics.histogram("simulation us", 100)};
+  auto entitiesGauge{metrics.gauge("entities")};
+  auto awakeGauge{metrics.gauge("awake entities")};
+  auto particlesGauge{metrics.gauge("particles")};
+  auto behavioursGauge{metrics.gauge("behaviours")};
+  const auto framesCounter{metrics.counter("frames")};
+  const auto frameMicroseconds{metrics.histogram("frame us", 1000)};
+  const auto audioPeriodsCounter{metrics.counter("audio periods")};
+  const auto audioXrunsCounter{metrics.counter("audio xruns")};
+  std::optional<SharedMetrics> sharedMetrics;
+  if (metricsName)
+    sharedMetrics.emplace(std::string{*metricsName},
+                          SharedMetrics::Access::create);
 
+  // --record=<path> logs each tick's input and state hashes, and
+  // --replay=<path> feeds a log's inputs back in place of the keyboard and
+  // checks the state against it, so that a build can be compared with the
+  // one that recorded. Both runs need the same level and options.
+  std::optional<std::ofstream> recordStream;
+  std::optional<ReplayWriter> recorder;
+  if (recordPath) {
+    recordStream.emplace(std::string{*recordPath}, std::ios::binary);
+    if (!*recordStream)
+      throw std::runtime_error{"unable to open " + std::string{*recordPath}};
+    recorder.emplace(*recordStream);
+  }
+  std::optional<std::ifstream> replayStream;
+  std::optional<ReplayReader> replay;
+  if (replayPath) {
+    replayStream.emplace(std::string{*replayPath}, std::ios::binary);
+    if (!*replayStream)
+      throw std::runtime_error{"unable to open " + std::string{*replayPath}};
+    replay.emplace(*replayStream);
+  }
   std::atomic<bool> quitAudioThread;
+  std::exception_ptr audioError;
   std::atomic<bool> playJumpSound;
-  const auto alsaPeriodSize{512};
+  AudioStats audioStats;
+  const auto audioSink{
+      makeAudioSink(audioSinkName, audioStats,
+                    startTuning(audioLatencyTuning).periodFrames)};
   std::thread audioThread{loopAudio,
                           std::ref(quitAudioThread),
+                          std::ref(audioError),
                           std::ref(playJumpSound),
                           readShortAudio(backgroundMusicPath),
                           readShortAudio(jumpSoundPath),
-                          initializeAlsaPcm(alsaPeriodSize),
-                          std::vector<short>(2 * alsaPeriodSize)};
-  {
+                          std::ref(*audioSink),
+                          audioLatencyTuning,
+                          std::ref(audioStats),
+                          audioPeriodsCounter,
+                          audioXrunsCounter};
+  ThreadStopper audioThreadStopper{quitAudioThread, audioThread};
+  // Only the ALSA sink blocks on a device. The file sink sleeps between
+  // periods and the null sink never waits, which at real-time priority
+  // would starve the other threads.
+  if (audioSinkName == "alsa") {
     sched_param param{sched_get_priority_max(SCHED_RR)};
     pthread_setschedparam(audioThread.native_handle(), SCHED_RR, &param);
   }
-  while (pollSdlEvents()) {
-    playerState = handleVerticalCollisions(
-        applyVerticalForces(applyHorizontalForces(playerState, groundFriction,
-                                                  playerMaxHorizontalSpeed,
-                                                  playerRunAcceleration),
-                            playerJumpAcceleration, gravity, playJumpSound),
-        {blockRectangle, pipeRectangle}, {blockRectangle}, floorRectangle);
-    playerState.object = handleHorizontalCollisions(
-        {playerState.object.rectangle, playerState.object.velocity},
-        {blockRectangle, pipeRectangle}, {blockRectangle, pipeRectangle},
-        levelRectangle);
-    playerState = applyVelocity(playerState);
-    if (leftEdge(playerState.object.rectangle) < leftEdge(enemy.rectangle))
-      enemy.velocity.horizontal = -1;
-    else if (leftEdge(playerState.object.rectangle) > leftEdge(enemy.rectangle))
-      enemy.velocity.horizontal = 1;
-    else
-      enemy.velocity.horizontal = 0;
-    enemy = handleHorizontalCollisions(enemy, {pipeRectangle}, {pipeRectangle},
-                                       levelRectangle);
-    enemy.rectangle = applyHorizontalVelocity(enemy);
+  const auto tileSize{16};
+  TileLayer tiles{Point{0, 0}, tileSize,
+                  static_cast<std::size_t>(
+                      (backgroundSourceWidth + tileSize - 1) / tileSize),
+                  cameraHeight / tileSize};
+  tiles.fill(floorRectangle);
+  // Bump whenever tiles or solids change.
+  const std::size_t geometryVersion{0};
+  ContactCacheCounts contactCacheCounts{};
+  ActivationStats activationStats{};
+  MovingCollisionStats movingCollisionStats{};
+  CullingIndex cullingIndex;
+  CullingStats cullingStats{};
+  std::atomic<bool> quitRenderThread;
+  std::exception_ptr renderError;
+  TripleBuffer<RenderSnapshot> renderSnapshots;
+  FrameTimes renderFrameTimes{};
+  FrameTimes simulationFrameTimes{};
+  FrameTimes hudFrameTimes{};
+  InputEventQueue inputEvents;
+  LatencyHistogram inputLatency{};
+  PresentSchedule presentSchedule;
+  ParallaxStats parallaxStats{};
+  ParticlePool particles{131072};
+  // With --capture=<prefix>, every presented frame is saved as
+  // <prefix>-<frame>.qoi, or dropped if the encoders fall behind.
+  std::optional<FrameCapture> capture;
+  if (capturePrefix)
+    capture.emplace(std::string{*capturePrefix}, screenWidth, screenHeight, 8,
+                    2);
+  std::thread renderThread{
+      loopRendering,
+      std::ref(quitRenderThread),
+      std::ref(renderError),
+      windowWrapper.window,
+      backgroundImageSurfaceWrapper.surface,
+      spriteSheetSurfaces,
+      pixelScale,
+      std::ref(renderSnapshots),
+      std::ref(renderFrameTimes),
+      std::ref(inputEvents),
+      std::ref(inputLatency),
+      std::ref(presentSchedule),
+      lateLatch,
+      std::span<SDL_Surface *const>{parallaxSurfaces},
+      std::move(parallaxLayers),
+      std::ref(parallaxStats),
+      framesCounter,
+      frameMicroseconds,
+      capture ? &*capture : nullptr,
+      std::cref(audioStats),
+      std::ref(hudFrameTimes)};
+  ThreadStopper renderThreadStopper{quitRenderThread, renderThread};
+  ReplayTick replayed{};
+  StateHashes stateHashes{};
+  std::optional<std::uint64_t> divergentTick;
+  std::string divergentField;
+  // Simulation runs at a fixed rate instead of waiting on vsync, unless late
+  // latching, where it runs once per present as late as it can.
+  constexpr std::chrono::nanoseconds simulationTick{std::chrono::seconds{1} /
+                                                    60};
+  auto nextTick{std::chrono::steady_clock::now()};
+  std::chrono::nanoseconds simulationBudget{};
+  std::uint64_t tick{0};
+  auto showHud{false};
+  std::chrono::nanoseconds previousTickDuration{};
+  while (!quitRenderThread && !quitAudioThread &&
+         pollSdlEvents(inputEvents, tick, showHud)) {
+    const auto tickStart{std::chrono::steady_clock::now()};
+    const auto activationCounts{updateActivation(
+        world, activationRegion(backgroundSourceRectangle, activationMargin))};
+    record(activationStats, activationCounts);
+    if (replay && !replay->read(replayed)) {
+      if (replay->truncated())
+        std::cerr << "replay truncated after " << tick << " ticks\n";
+      break;
+    }
+    const auto input{replay ? replayed.input : keyboardInput()};
+    world.each<Rectangle, Velocity, JumpState, DirectionFacing,
+               ContactCache, Activation, KeyboardControlled>(
+        [&](Rectangle &rectangle, Velocity &velocity, JumpState &jumpState,
+            DirectionFacing &directionFacing, ContactCache &contactCache,
+            const Activation &activation, const KeyboardControlled &) {
+          if (!activation.awake)
+            return;
+          const auto wasGrounded{jumpState == JumpState::grounded};
+          const auto forced{applyVerticalForces(
+              applyHorizontalForces(playerState(rectangle, velocity,
+                                                jumpState, directionFacing),
+                                    input, groundFriction,
+                                    playerMaxHorizontalSpeed,
+                                    playerRunAcceleration),
+              input, playerJumpAcceleration, gravity)};
+          if (wasGrounded && forced.jumpState == JumpState::started)
+            playJumpSound = true;
+          const auto solids{solidsNear(forced.object)};
+          store(handleVerticalCollisions(forced, contactCache,
+                                         contactCacheCounts, geometryVersion,
+                                         tiles, solids, solids,
+                                         floorRectangle),
+                rectangle, velocity, jumpState, directionFacing);
+          if (!wasGrounded && jumpState == JumpState::grounded)
+            spawnLandingDust(particles, rectangle);
+        });
+    world.each<Rectangle, Velocity, JumpState, ContactCache, Activation>(
+        [&](Rectangle &rectangle, Velocity &velocity, const JumpState &,
+            ContactCache &contactCache, const Activation &activation) {
+          if (!activation.awake)
+            return;
+          const auto solids{solidsNear({rectangle, velocity})};
+          store(handleHorizontalCollisions(
+                    {rectangle, velocity}, contactCache, contactCacheCounts,
+                    geometryVersion, tiles, solids, solids, levelRectangle),
+                rectangle, velocity);
+        });
+    Rectangle playerRectangle{};
+    world.each<Rectangle, Velocity, KeyboardControlled>(
+        [&playerRectangle](const Rectangle &rectangle, const Velocity &velocity,
+                           const KeyboardControlled &) {
+          playerRectangle = applyVelocity({rectangle, velocity}).rectangle;
+        });
+    world.each<Rectangle, Activation, Scripted>(
+        [&](const Rectangle &rectangle, const Activation &activation,
+            const Scripted &scripted) {
+          auto &view{behaviours.view(scripted.behaviour)};
+          view.self = rectangle;
+          view.player = playerRectangle;
+          view.awake = activation.awake;
+        });
+    behaviours.tick();
+    world.each<Rectangle, Velocity, DirectionFacing, ContactCache, Activation,
+               Scripted>([&](Rectangle &rectangle, Velocity &velocity,
+                             DirectionFacing &directionFacing,
+                             ContactCache &contactCache,
+                             const Activation &activation,
+                             const Scripted &scripted) {
+      if (!activation.awake)
+        return;
+      auto &view{behaviours.view(scripted.behaviour)};
+      auto state{playerState(rectangle, velocity, view.jumpState,
+                             directionFacing)};
+      state.object.velocity.horizontal = view.horizontalVelocity;
+      if (view.jump && state.jumpState == JumpState::grounded) {
+        state.jumpState = JumpState::started;
+        state.object.velocity.vertical += playerJumpAcceleration;
+      }
+      state.object.velocity.vertical += gravity;
+      const auto solids{solidsNear(state.object)};
+      state = handleVerticalCollisions(state, contactCache, contactCacheCounts,
+                                       geometryVersion, tiles, solids, solids,
+                                       floorRectangle);
+      const auto nearSolids{solidsNear(state.object)};
+      state.object = handleHorizontalCollisions(
+          state.object, contactCache, contactCacheCounts, geometryVersion,
+          tiles, nearSolids, nearSolids, levelRectangle);
+      view.jumpState = state.jumpState;
+      store(state.object, rectangle, velocity);
+    });
+    record(movingCollisionStats, movingCollisionSystem.update(world));
+    world.each<Rectangle, Velocity, Activation>(
+        [](Rectangle &rectangle, Velocity &velocity,
+           const Activation &activation) {
+          if (activation.awake)
+            store(applyVelocity({rectangle, velocity}), rectangle, velocity);
+        });
+    world.each<Velocity, DirectionFacing, Activation, Scripted>(
+        [](const Velocity &velocity, DirectionFacing &directionFacing,
+           const Activation &activation, const Scripted &) {
+          if (activation.awake)
+            directionFacing = velocity.horizontal < 0
+                                  ? DirectionFacing::left
+                                  : DirectionFacing::right;
+        });
+    world.each<Rectangle, KeyboardControlled>(
+        [&playerRectangle](const Rectangle &rectangle,
+                           const KeyboardControlled &) {
+          playerRectangle = rectangle;
+        });
+    triggerEvents.clear();
+    updateOccupancy(triggerZones, playerTriggers, playerRectangle,
+                    triggerEvents, triggerStats);
+    for (const auto &event : triggerEvents) {
+      if (!event.entered)
+        continue;
+      const auto &zone{triggerZones.zone(event.zone)};
+      switch (zone.kind) {
+      case TriggerKind::checkpoint:
+        checkpoint = {leftEdge(zone.region),
+                      bottomEdge(zone.region) + 1 - playerHeight};
+        break;
+      case TriggerKind::killPlane:
+        world.each<Rectangle, Velocity, JumpState, KeyboardControlled>(
+            [&](Rectangle &rectangle, Velocity &velocity,
+                JumpState &jumpState, const KeyboardControlled &) {
+              rectangle.origin = checkpoint;
+              velocity = {{0, 1}, 0};
+              jumpState = JumpState::grounded;
+            });
+        break;
+      case TriggerKind::spawner:
+        if (!spawnersUsed[event.zone]) {
+          spawnersUsed[event.zone] = true;
+          spawnGuard(rightEdge(zone.region) + cameraWidth / 2,
+                     static_cast<distance_type>(zone.value));
+        }
+        break;
+      case TriggerKind::musicCue:
+        break;
+      }
+    }
     backgroundSourceRectangle =
         shiftBackground(backgroundSourceRectangle, backgroundSourceWidth,
-                        playerState.object.rectangle, cameraWidth);
-    present(rendererWrapper, backgroundTextureWrapper,
-            backgroundSourceRectangle, pixelScale,
-            {Point{0, 0}, cameraWidth, cameraHeight});
-    present(rendererWrapper, enemyTextureWrapper, enemySourceRect, pixelScale,
-            shiftHorizontally(enemy.rectangle,
-                              -leftEdge(backgroundSourceRectangle)),
-            enemy.velocity.horizontal < 0 ? SDL_FLIP_HORIZONTAL
-                                          : SDL_FLIP_NONE);
-    present(rendererWrapper, playerTextureWrapper, playerSourceRect, pixelScale,
-            shiftHorizontally(playerState.object.rectangle,
-                              -leftEdge(backgroundSourceRectangle)),
-            playerState.directionFacing == DirectionFacing::right
-                ? SDL_FLIP_NONE
-                : SDL_FLIP_HORIZONTAL);
-    SDL_RenderPresent(rendererWrapper.renderer);
+                        playerRectangle, cameraWidth);
+    if (recorder || replay) {
+      hashState(world, backgroundSourceRectangle, stateHashes);
+      if (recorder)
+        recorder->write({input, stateHashes});
+      if (replay && !divergentTick)
+        if (auto divergence{
+                describeDivergence(replayed.hashes, stateHashes)}) {
+          divergentTick = tick;
+          divergentField = std::move(*divergence);
+        }
+    }
+    particles.update(gravity, topEdge(floorRectangle));
+    if (animationTable)
+      animate(world, *animationTable, tick);
+    auto &snapshot{renderSnapshots.back()};
+    snapshot.tick = tick;
+    snapshot.camera = backgroundSourceRectangle;
+    snapshot.simulationNanoseconds = previousTickDuration.count();
+    snapshot.entities = world.count<Rectangle>();
+    snapshot.showHud = showHud;
+    snapshot.sprites.clear();
+    cullingIndex.sync(world);
+    record(cullingStats,
+           cullingIndex.visible(
+               world, backgroundSourceRectangle, [&](const Drawable &drawable) {
+                 snapshot.sprites.push_back(
+                     {narrow(drawable.sprite.source),
+                      relativeTo(drawable.rectangle,
+                                 backgroundSourceRectangle.origin),
+                      drawable.sprite.sheet,
+                      drawable.directionFacing == DirectionFacing::left});
+               }));
+    snapshot.particles.resize(particlePalette.size());
+    for (auto &byColor : snapshot.particles)
+      byColor.clear();
+    particles.collect(backgroundSourceRectangle, snapshot.particles);
+    renderSnapshots.publish();
+    const auto tickEnd{std::chrono::steady_clock::now()};
+    record(simulationFrameTimes, tickEnd - tickStart);
+    ticksCounter.add();
+    simulationMicroseconds.record(
+        std::chrono::duration_cast<std::chrono::microseconds>(tickEnd -
+                                                              tickStart)
+            .count());
+    entitiesGauge.set(
+        static_cast<std::int64_t>(world.count<Rectangle, Velocity>()));
+    awakeGauge.set(static_cast<std::int64_t>(activationCounts.active));
+    particlesGauge.set(static_cast<std::int64_t>(particles.live()));
+    behavioursGauge.set(static_cast<std::int64_t>(behaviours.size()));
+    if (sharedMetrics)
+      metrics.publish(sharedMetrics->segment());
+    previousTickDuration = tickEnd - tickStart;
+    simulationBudget = decayingMaximum(simulationBudget, tickEnd - tickStart);
+    ++tick;
+    nextTick = lateLatch ? lateLatchTick(presentSchedule, nextTick,
+                                         simulationBudget, simulationTick)
+                         : std::max(nextTick + simulationTick, tickEnd);
+    std::this_thread::sleep_until(nextTick);
   }
-  quitAudioThread = true;
-  audioThread.join();
-  return EXIT_SUCCESS;
+  renderThreadStopper.stop();
+  audioThreadStopper.stop();
+  if (renderError)
+    std::rethrow_exception(renderError);
+  if (audioError)
+    std::rethrow_exception(audioError);
+  dump(std::cout, audioStats);
+  dump(std::cout, contactCacheCounts);
+  dump(std::cout, activationStats);
+  dump(std::cout, movingCollisionStats);
+  dump(std::cout, cullingStats);
+  dump(std::cout, "simulation", simulationFrameTimes);
+  dump(std::cout, "render", renderFrameTimes);
+  dump(std::cout, "hud", hudFrameTimes);
+  dump(std::cout, inputLatency);
+  dump(std::cout, parallaxStats);
+  dump(std::cout, particles);
+  dump(std::cout, behaviours);
+  dump(std::cout, triggerStats);
+  if (capture)
+    dump(std::cout, *capture);
+  if (divergentTick)
+    std::cout << "replay diverged at tick " << *divergentTick << " in "
+              << divergentField << '\n';
+  else if (replay)
+    std::cout << "replay matched for " << tick << " ticks\n";
+  return divergentTick ? EXIT_FAILURE : EXIT_SUCCESS;
 }
 } // namespace sbash64::game
 
+static auto optionValue(std::span<char *> options, std::string_view name)
+    -> std::optional<std::string_view> {
+  for (const std::string_view option : options)
+    if (option.size() > name.size() && option.starts_with(name) &&
+        option[name.size()] == '=')
+      return option.substr(name.size() + 1);
+  return std::nullopt;
+}
+
+static auto parseFrames(std::string_view text) -> std::int64_t {
+  std::int64_t frames{};
+  if (const auto [end, error]{
+          std::from_chars(text.data(), text.data() + text.size(), frames)};
+      error != std::errc{} || end != text.data() + text.size() || frames <= 0)
+    throw std::runtime_error{"invalid audio period: " + std::string{text}};
+  return frames;
+}
+
+// --audio-period=<frames> fixes the ALSA period size, while
+// --audio-period=<minimum>-<maximum> or --audio-period=auto let loopAudio
+// search for the smallest period size that does not underrun.
+static auto audioLatencyTuning(std::span<char *> options)
+    -> sbash64::game::AudioLatencyTuning {
+  const auto value{optionValue(options, "--audio-period")};
+  if (!value)
+    return sbash64::game::fixedLatency(512);
+  if (*value == "auto")
+    return {64, 2048, 2, 10 * sbash64::game::audioSampleRate};
+  if (const auto separator{value->find('-')};
+      separator != std::string_view::npos) {
+    const auto minimum{parseFrames(value->substr(0, separator))};
+    const auto maximum{parseFrames(value->substr(separator + 1))};
+    if (maximum < minimum)
+      throw std::runtime_error{"invalid audio period range"};
+    return {minimum, maximum, 2, 10 * sbash64::game::audioSampleRate};
+  }
+  return sbash64::game::fixedLatency(parseFrames(*value));
+}
+
+// --activation-margin=<pixels> sets how far outside the camera entities
+// stay awake.
+static auto activationMargin(std::span<char *> options)
+    -> sbash64::game::distance_type {
+  const auto value{optionValue(options, "--activation-margin")};
+  if (!value)
+    return 64;
+  sbash64::game::distance_type margin{};
+  if (const auto [end, error]{std::from_chars(
+          value->data(), value->data() + value->size(), margin)};
+      error != std::errc{} || end != value->data() + value->size() ||
+      margin < 0)
+    throw std::runtime_error{"invalid activation margin: " +
+                             std::string{*value}};
+  return margin;
+}
+
+// Each --parallax-layer=<image>:<percent> adds a horizontally repeating
+// layer scrolled at that percentage of the camera's speed.
+static auto parallaxLayerImages(std::span<char *> options)
+    -> std::vector<sbash64::game::ParallaxLayerImage> {
+  constexpr std::string_view name{"--parallax-layer="};
+  std::vector<sbash64::game::ParallaxLayerImage> images;
+  for (const std::string_view option : options) {
+    if (!option.starts_with(name))
+      continue;
+    const auto value{option.substr(name.size())};
+    const auto separator{value.rfind(':')};
+    int percent{};
+    if (separator == std::string_view::npos ||
+        std::from_chars(value.data() + separator + 1,
+                        value.data() + value.size(), percent)
+                .ptr != value.data() + value.size())
+      throw std::runtime_error{"invalid parallax layer: " +
+                               std::string{value}};
+    images.push_back({std::string{value.substr(0, separator)}, percent});
+  }
+  return images;
+}
+
+// --late-latch samples input just before each frame is drawn instead of at a
+// fixed rate.
+static auto lateLatch(std::span<char *> options) -> bool {
+  return std::ranges::any_of(options, [](std::string_view option) {
+    return option == "--late-latch";
+  });
+}
+
 int main(int argc, char *argv[]) {
   std::span<char *> arguments{argv,
                               static_cast<std::span<char *>::size_type>(argc)};
@@ -436,8 +1152,20 @@ int main(int argc, char *argv[]) {
     return EXIT_FAILURE;
   try {
     return sbash64::game::run(arguments[1], arguments[2], arguments[3],
-                              arguments[4], arguments[5]);
-  } catch (const std::runtime_error &e) {
+                              arguments[4], arguments[5],
+                              audioLatencyTuning(arguments.subspan(6)),
+                              optionValue(arguments.subspan(6), "--audio-sink")
+                                  .value_or("alsa"),
+                              activationMargin(arguments.subspan(6)),
+                              lateLatch(arguments.subspan(6)),
+                              parallaxLayerImages(arguments.subspan(6)),
+                              optionValue(arguments.subspan(6), "--animations"),
+                              optionValue(arguments.subspan(6), "--atlas"),
+                              optionValue(arguments.subspan(6), "--record"),
+                              optionValue(arguments.subspan(6), "--replay"),
+                              optionValue(arguments.subspan(6), "--metrics"),
+                              optionValue(arguments.subspan(6), "--capture"));
+  } catch (const std::exception &e) {
     std::cerr << e.what() << '\n';
     return EXIT_FAILURE;
   }
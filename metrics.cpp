@@ -0,0 +1,185 @@
+#include <sbash64/game/metrics.hpp>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace sbash64::game {
+constexpr std::array<char, 4> magic{'S', 'B', 'M', 'T'};
+constexpr std::uint32_t version{1};
+
+[[noreturn]] static void throwSystemError(std::string_view message,
+                                          const std::string &name) {
+  std::stringstream stream;
+  stream << message << ' ' << name << ": " << std::strerror(errno);
+  throw std::runtime_error{stream.str()};
+}
+
+template <typename T> static void add(std::atomic<T> &total, T amount) {
+  total.store(total.load(std::memory_order_relaxed) + amount,
+              std::memory_order_relaxed);
+}
+
+void Counter::add(std::int64_t amount) { game::add(metric->value, amount); }
+
+void Gauge::set(std::int64_t value) {
+  metric->value.store(value, std::memory_order_relaxed);
+}
+
+void Histogram::record(std::int64_t value) {
+  const auto bucket{std::clamp(value / metric->bucketWidth, std::int64_t{0},
+                               std::int64_t{histogramBuckets - 1})};
+  game::add(metric->buckets[static_cast<std::size_t>(bucket)],
+            std::uint64_t{1});
+  game::add(metric->value, value);
+}
+
+auto MetricsRegistry::counter(std::string_view name) -> Counter {
+  return Counter{add(name, MetricKind::counter, 1)};
+}
+
+auto MetricsRegistry::gauge(std::string_view name) -> Gauge {
+  return Gauge{add(name, MetricKind::gauge, 1)};
+}
+
+auto MetricsRegistry::histogram(std::string_view name,
+                                std::int64_t bucketWidth) -> Histogram {
+  if (bucketWidth <= 0)
+    throw std::runtime_error{"invalid histogram bucket width"};
+  return Histogram{add(name, MetricKind::histogram, bucketWidth)};
+}
+
+auto MetricsRegistry::add(std::string_view name, MetricKind kind,
+                          std::int64_t bucketWidth) -> Metric & {
+  if (count == metrics.size())
+    throw std::runtime_error{"too many metrics"};
+  auto &metric{metrics[count++]};
+  metric.name = {};
+  std::copy_n(name.begin(), std::min(name.size(), metric.name.size() - 1),
+              metric.name.begin());
+  metric.kind = kind;
+  metric.bucketWidth = bucketWidth;
+  return metric;
+}
+
+// Names, kinds and bucket widths never change once published, so only the
+// values need the sequence lock.
+void MetricsRegistry::publish(MetricsSegment &segment) const {
+  const auto named{segment.metrics.load(std::memory_order_relaxed)};
+  for (auto i{named}; i < count; ++i) {
+    segment.snapshot[i].name = metrics[i].name;
+    segment.snapshot[i].kind = metrics[i].kind;
+    segment.snapshot[i].bucketWidth = metrics[i].bucketWidth;
+  }
+  const auto sequence{segment.sequence.load(std::memory_order_relaxed)};
+  segment.sequence.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  for (std::size_t i{0}; i < count; ++i) {
+    auto &published{segment.snapshot[i]};
+    published.value.store(metrics[i].value.load(std::memory_order_relaxed),
+                          std::memory_order_relaxed);
+    if (metrics[i].kind == MetricKind::histogram)
+      for (std::size_t b{0}; b < histogramBuckets; ++b)
+        published.buckets[b].store(
+            metrics[i].buckets[b].load(std::memory_order_relaxed),
+            std::memory_order_relaxed);
+  }
+  segment.metrics.store(count, std::memory_order_release);
+  segment.sequence.store(sequence + 2, std::memory_order_release);
+}
+
+SharedMetrics::SharedMetrics(const std::string &name, Access access)
+    : name{name}, access{access} {
+  const auto descriptor{access == Access::create
+                            ? shm_open(name.c_str(), O_CREAT | O_RDWR, 0644)
+                            : shm_open(name.c_str(), O_RDONLY, 0)};
+  if (descriptor < 0)
+    throwSystemError("unable to open shared memory", name);
+  if (access == Access::create &&
+      ftruncate(descriptor, sizeof(MetricsSegment)) != 0) {
+    close(descriptor);
+    throwSystemError("unable to size shared memory", name);
+  }
+  struct stat status {};
+  if (fstat(descriptor, &status) != 0 ||
+      static_cast<std::size_t>(status.st_size) < sizeof(MetricsSegment)) {
+    close(descriptor);
+    throw std::runtime_error{"not a metrics segment: " + name};
+  }
+  auto *address{mmap(nullptr, sizeof(MetricsSegment),
+                     access == Access::create ? PROT_READ | PROT_WRITE
+                                              : PROT_READ,
+                     MAP_SHARED, descriptor, 0)};
+  close(descriptor);
+  if (address == MAP_FAILED)
+    throwSystemError("unable to map shared memory", name);
+  if (access == Access::create) {
+    mapped = new (address) MetricsSegment{};
+    mapped->magic = magic;
+    mapped->version = version;
+  } else {
+    mapped = static_cast<MetricsSegment *>(address);
+    if (mapped->magic != magic || mapped->version != version) {
+      munmap(address, sizeof(MetricsSegment));
+      throw std::runtime_error{"not a metrics segment: " + name};
+    }
+  }
+}
+
+SharedMetrics::~SharedMetrics() {
+  munmap(mapped, sizeof(MetricsSegment));
+  if (access == Access::create)
+    shm_unlink(name.c_str());
+}
+
+auto SharedMetrics::segment() const -> MetricsSegment & { return *mapped; }
+
+// Publishing takes microseconds, so a sequence left odd or changing for
+// this long means the writer died or stopped partway through.
+constexpr auto readAttempts{1000};
+constexpr std::chrono::milliseconds readRetryInterval{1};
+
+auto read(const MetricsSegment &segment,
+          std::array<MetricValue, maximumMetrics> &values) -> std::size_t {
+  for (auto attempt{0}; attempt < readAttempts; ++attempt) {
+    if (attempt != 0)
+      std::this_thread::sleep_for(readRetryInterval);
+    const auto sequence{segment.sequence.load(std::memory_order_acquire)};
+    if (sequence % 2 != 0)
+      continue;
+    const auto count{std::min<std::size_t>(
+        segment.metrics.load(std::memory_order_acquire), values.size())};
+    for (std::size_t i{0}; i < count; ++i) {
+      const auto &published{segment.snapshot[i]};
+      auto &value{values[i]};
+      value.name = published.name;
+      value.kind = published.kind;
+      value.bucketWidth = published.bucketWidth;
+      value.value = published.value.load(std::memory_order_relaxed);
+      for (std::size_t b{0}; b < histogramBuckets; ++b)
+        value.buckets[b] =
+            published.buckets[b].load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (segment.sequence.load(std::memory_order_relaxed) == sequence)
+      return count;
+  }
+  throw std::runtime_error{"metrics writer stalled"};
+}
+} // namespace sbash64::game
@@ -0,0 +1,91 @@
+#include <sbash64/game/components.hpp>
+#include <sbash64/game/game.hpp>
+#include <sbash64/game/moving-collisions.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace sbash64::game {
+constexpr auto movingObjects{10'000};
+constexpr auto frames{100};
+// The pair scan is slow enough that only every tenth frame is scanned.
+constexpr auto scannedEvery{10};
+
+// Steps 10k enemies bouncing around a region of the given size, timing
+// the moving collision system's update against testing every pair of
+// swept rectangles for overlap.
+static void measure(distance_type width, distance_type height) {
+  GameWorld world;
+  std::mt19937_64 engine{30};
+  const auto between{[&](distance_type low, distance_type high) {
+    return std::uniform_int_distribution<distance_type>{low, high}(engine);
+  }};
+  for (auto i{0}; i < movingObjects; ++i)
+    world.archetype<EnemyArchetype>().create(
+        Rectangle{Point{between(0, width), between(0, height)}, 16, 16},
+        Velocity{{between(-3, 3), 1}, between(-3, 3)}, DirectionFacing::left,
+        Sprite{}, Scripted{}, MovingCollider{}, ContactCache{}, Activation{},
+        Animated{});
+  MovingCollisionSystem system{4};
+  MovingCollisionStats stats{};
+  std::vector<Rectangle> swept;
+  std::chrono::steady_clock::duration updating{};
+  std::chrono::steady_clock::duration scanning{};
+  std::uint64_t scannedPairs{0};
+  for (auto frame{0}; frame < frames; ++frame) {
+    swept.clear();
+    world.each<Rectangle, Velocity>(
+        [&](const Rectangle &rectangle, const Velocity &velocity) {
+          swept.push_back(
+              unite(rectangle, applyVelocity({rectangle, velocity}).rectangle));
+        });
+    const auto scanStart{std::chrono::steady_clock::now()};
+    if (frame % scannedEvery == 0)
+      for (std::size_t i{0}; i < swept.size(); ++i)
+        for (auto j{i + 1}; j < swept.size(); ++j)
+          if (overlaps(swept[i], swept[j]))
+            ++scannedPairs;
+    const auto updateStart{std::chrono::steady_clock::now()};
+    record(stats, system.update(world));
+    const auto updateEnd{std::chrono::steady_clock::now()};
+    scanning += updateStart - scanStart;
+    updating += updateEnd - updateStart;
+    world.each<Rectangle, Velocity>(
+        [&](Rectangle &rectangle, Velocity &velocity) {
+          rectangle = applyVelocity({rectangle, velocity}).rectangle;
+          if (rectangle.origin.x < 0 || rectangle.origin.x > width)
+            velocity.horizontal = -velocity.horizontal;
+          if (rectangle.origin.y < 0 || rectangle.origin.y > height)
+            velocity.vertical.numerator = -velocity.vertical.numerator;
+        });
+  }
+  const auto perFrame{
+      [](std::chrono::steady_clock::duration duration, int count) {
+        return std::chrono::duration<double, std::milli>{duration}.count() /
+               count;
+      }};
+  constexpr auto scannedFrames{frames / scannedEvery};
+  std::cout << movingObjects << " objects in " << width << 'x' << height
+            << ":\n"
+            << "update: " << perFrame(updating, frames) << " ms per frame, "
+            << stats.total.candidatePairs / frames << " candidate pairs, "
+            << stats.total.reinsertions / frames << " reinsertions, "
+            << stats.total.collisions / frames << " collisions\n"
+            << "pair scan: " << perFrame(scanning, scannedFrames)
+            << " ms per frame, " << scannedPairs / scannedFrames
+            << " overlapping pairs\n";
+}
+
+static auto run() -> int {
+  measure(4000, 1500);
+  measure(40000, 1500);
+  return EXIT_SUCCESS;
+}
+} // namespace sbash64::game
+
+int main() { return sbash64::game::run(); }
@@ -0,0 +1,118 @@
+#include <sbash64/game/moving-collisions.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <ostream>
+#include <type_traits>
+#include <vector>
+
+namespace sbash64::game {
+static auto sweep(MovingObject object) -> Rectangle {
+  return unite(object.rectangle, applyVelocity(object).rectangle);
+}
+
+MovingCollisionSystem::MovingCollisionSystem(distance_type fatMargin)
+    : tree{fatMargin} {}
+
+auto MovingCollisionSystem::update(GameWorld &world) -> MovingCollisionCounts {
+  MovingCollisionCounts counts{};
+  bodies.clear();
+  world.eachArchetype([&](auto &archetype) {
+    using A = std::remove_reference_t<decltype(archetype)>;
+    if constexpr (A::template has<MovingCollider>) {
+      const auto rectangles{archetype.template column<Rectangle>()};
+      const auto velocities{archetype.template column<Velocity>()};
+      const auto colliders{archetype.template column<MovingCollider>()};
+      for (std::size_t row{0}; row < archetype.size(); ++row) {
+        auto &proxy{colliders[row].proxy};
+        if constexpr (A::template has<Activation>)
+          if (!archetype.template column<Activation>()[row].awake) {
+            if (proxy != DynamicAabbTree::nullNode) {
+              tree.remove(proxy);
+              proxy = DynamicAabbTree::nullNode;
+            }
+            continue;
+          }
+        JumpState *jumpState{nullptr};
+        if constexpr (A::template has<JumpState>)
+          jumpState = &archetype.template column<JumpState>()[row];
+        const auto swept{sweep({rectangles[row], velocities[row]})};
+        if (proxy == DynamicAabbTree::nullNode) {
+          proxy = tree.insert(swept, bodies.size());
+          ++counts.reinsertions;
+        } else {
+          if (tree.move(proxy, swept))
+            ++counts.reinsertions;
+          tree.setUserData(proxy, bodies.size());
+        }
+        bodies.push_back({&rectangles[row], &velocities[row], jumpState});
+      }
+    }
+  });
+  counts.colliders = bodies.size();
+
+  pairs.clear();
+  tree.candidatePairs(pairs);
+  counts.candidatePairs = pairs.size();
+  for (const auto &[firstIndex, secondIndex] : pairs) {
+    const auto &first{bodies[firstIndex]};
+    const auto &second{bodies[secondIndex]};
+    const auto result{
+        handleMovingCollision({*first.rectangle, *first.velocity},
+                              {*second.rectangle, *second.velocity})};
+    if (result.collision == MovingCollision::none)
+      continue;
+    ++counts.collisions;
+    *first.rectangle = result.first.rectangle;
+    *first.velocity = result.first.velocity;
+    *second.rectangle = result.second.rectangle;
+    *second.velocity = result.second.velocity;
+    if (result.collision == MovingCollision::firstLanded &&
+        first.jumpState != nullptr)
+      *first.jumpState = JumpState::grounded;
+    if (result.collision == MovingCollision::secondLanded &&
+        second.jumpState != nullptr)
+      *second.jumpState = JumpState::grounded;
+  }
+  return counts;
+}
+
+static void raise(MovingCollisionCounts &maximum,
+                  MovingCollisionCounts counts) {
+  maximum.colliders = std::max(maximum.colliders, counts.colliders);
+  maximum.reinsertions = std::max(maximum.reinsertions, counts.reinsertions);
+  maximum.candidatePairs =
+      std::max(maximum.candidatePairs, counts.candidatePairs);
+  maximum.collisions = std::max(maximum.collisions, counts.collisions);
+}
+
+void record(MovingCollisionStats &stats, MovingCollisionCounts counts) {
+  stats.latest = counts;
+  raise(stats.maximum, counts);
+  stats.total.colliders += counts.colliders;
+  stats.total.reinsertions += counts.reinsertions;
+  stats.total.candidatePairs += counts.candidatePairs;
+  stats.total.collisions += counts.collisions;
+  ++stats.frames;
+}
+
+static auto mean(std::size_t total, std::size_t frames) -> std::size_t {
+  return frames == 0 ? 0 : total / frames;
+}
+
+void dump(std::ostream &stream, const MovingCollisionStats &stats) {
+  const auto line{[&](const char *name, std::size_t latest,
+                      std::size_t total, std::size_t maximum) {
+    stream << "moving " << name << " (latest/mean/max): " << latest << '/'
+           << mean(total, stats.frames) << '/' << maximum << '\n';
+  }};
+  line("colliders", stats.latest.colliders, stats.total.colliders,
+       stats.maximum.colliders);
+  line("reinsertions", stats.latest.reinsertions, stats.total.reinsertions,
+       stats.maximum.reinsertions);
+  line("candidate pairs", stats.latest.candidatePairs,
+       stats.total.candidatePairs, stats.maximum.candidatePairs);
+  line("collisions", stats.latest.collisions, stats.total.collisions,
+       stats.maximum.collisions);
+}
+} // namespace sbash64::game
@@ -0,0 +1,206 @@
+#include <sbash64/game/animation-table.hpp>
+#include <sbash64/game/atlas-packer.hpp>
+#include <sbash64/game/components.hpp>
+#include <sbash64/game/game.hpp>
+#include <sbash64/game/screen-space.hpp>
+#include <sbash64/game/sdl-wrappers.hpp>
+
+#include <SDL.h>
+#include <SDL_image.h>
+#include <SDL_pixels.h>
+#include <SDL_surface.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Packs the sprite frames named by a manifest into atlas images and writes
+// the animation table that the game loads with --animations. Manifest
+// lines, with # starting a comment, are
+//
+//   sheet <name> <image> <color key x> <color key y>
+//   animation <name>
+//   frame <sheet name> <x> <y> <width> <height> <ticks>
+//
+// where frames belong to the animation above them and ticks are simulation
+// ticks at 60 Hz.
+namespace sbash64::game {
+namespace {
+struct Sheet {
+  std::unique_ptr<sdl_wrappers::Surface> pixels;
+  Uint32 colorKey;
+};
+
+struct Manifest {
+  std::map<std::string, std::size_t> sheetIndices;
+  std::vector<Sheet> sheets;
+  std::vector<AnimationDefinition> animations;
+};
+} // namespace
+
+static auto loadSheet(const std::string &path, distance_type keyX,
+                      distance_type keyY) -> Sheet {
+  const sdl_wrappers::ImageSurface image{path};
+  auto pixels{std::make_unique<sdl_wrappers::Surface>(
+      SDL_ConvertSurfaceFormat(image.surface, SDL_PIXELFORMAT_ARGB8888, 0))};
+  if (isNegative(keyX) || isNegative(keyY) || keyX >= pixels->surface->w ||
+      keyY >= pixels->surface->h)
+    throw std::runtime_error{"color key pixel outside of " + path};
+  const auto colorKey{static_cast<const Uint32 *>(
+      pixels->surface->pixels)[keyY * pixels->surface->pitch / 4 + keyX]};
+  return {std::move(pixels), colorKey};
+}
+
+static auto sameFrame(const Sprite &a, const Sprite &b) -> bool {
+  return a.sheet == b.sheet && a.source.origin.x == b.source.origin.x &&
+         a.source.origin.y == b.source.origin.y &&
+         a.source.width == b.source.width &&
+         a.source.height == b.source.height;
+}
+
+static auto readManifest(std::istream &stream) -> Manifest {
+  Manifest manifest;
+  std::string line;
+  for (auto lineNumber{1}; std::getline(stream, line); ++lineNumber) {
+    std::istringstream fields{line.substr(0, line.find('#'))};
+    std::string kind;
+    if (!(fields >> kind))
+      continue;
+    const auto invalid{[&] {
+      return std::runtime_error{"invalid manifest line " +
+                                std::to_string(lineNumber)};
+    }};
+    if (kind == "sheet") {
+      std::string name;
+      std::string path;
+      distance_type keyX{};
+      distance_type keyY{};
+      if (!(fields >> name >> path >> keyX >> keyY) ||
+          manifest.sheetIndices.contains(name))
+        throw invalid();
+      manifest.sheetIndices[name] = manifest.sheets.size();
+      manifest.sheets.push_back(loadSheet(path, keyX, keyY));
+    } else if (kind == "animation") {
+      std::string name;
+      if (!(fields >> name))
+        throw invalid();
+      manifest.animations.push_back({name, {}});
+    } else if (kind == "frame") {
+      std::string sheet;
+      Rectangle source{};
+      int ticks{};
+      if (manifest.animations.empty() ||
+          !(fields >> sheet >> source.origin.x >> source.origin.y >>
+            source.width >> source.height >> ticks) ||
+          !manifest.sheetIndices.contains(sheet) || ticks <= 0 ||
+          ticks > UINT16_MAX || source.width <= 0 || source.height <= 0)
+        throw invalid();
+      manifest.animations.back().frames.push_back(
+          {Sprite{source, manifest.sheetIndices.at(sheet)},
+           static_cast<std::uint16_t>(ticks)});
+    } else
+      throw invalid();
+  }
+  return manifest;
+}
+
+static auto run(const std::string &manifestPath,
+                const std::string &outputPrefix,
+                screen_distance_type atlasSize) -> int {
+  sdl_wrappers::ImageInit sdlImageInitialization;
+  std::ifstream manifestStream{manifestPath};
+  if (!manifestStream)
+    throw std::runtime_error{"unable to open " + manifestPath};
+  auto manifest{readManifest(manifestStream)};
+  // Frames repeated across animations are packed once.
+  std::vector<Sprite> uniqueFrames;
+  std::vector<std::size_t> uniqueIndices;
+  for (const auto &animation : manifest.animations)
+    for (const auto &frame : animation.frames) {
+      const auto found{std::find_if(uniqueFrames.begin(), uniqueFrames.end(),
+                                    [&frame](const Sprite &packed) {
+                                      return sameFrame(packed, frame.sprite);
+                                    })};
+      uniqueIndices.push_back(
+          static_cast<std::size_t>(found - uniqueFrames.begin()));
+      if (found == uniqueFrames.end())
+        uniqueFrames.push_back(frame.sprite);
+    }
+  std::vector<Rectangle> sizes;
+  for (const auto &frame : uniqueFrames)
+    sizes.push_back(frame.source);
+  const auto placements{packAtlases(sizes, atlasSize, atlasSize, 1)};
+  std::size_t atlasCount{0};
+  for (const auto &placement : placements)
+    atlasCount = std::max(atlasCount, placement.atlas + 1);
+  std::vector<std::unique_ptr<sdl_wrappers::Surface>> atlases;
+  for (std::size_t i{0}; i < atlasCount; ++i)
+    atlases.push_back(std::make_unique<sdl_wrappers::Surface>(
+        SDL_CreateRGBSurfaceWithFormat(0, atlasSize, atlasSize, 32,
+                                       SDL_PIXELFORMAT_ARGB8888)));
+  for (auto &sheet : manifest.sheets) {
+    SDL_SetColorKey(sheet.pixels->surface, SDL_TRUE, sheet.colorKey);
+    SDL_SetSurfaceBlendMode(sheet.pixels->surface, SDL_BLENDMODE_NONE);
+  }
+  for (std::size_t i{0}; i < uniqueFrames.size(); ++i) {
+    const auto sourceRectangle{narrow(uniqueFrames[i].source)};
+    SDL_Rect source{sourceRectangle.origin.x, sourceRectangle.origin.y,
+                    sourceRectangle.width, sourceRectangle.height};
+    const auto origin{narrow({placements[i].origin, 0, 0}).origin};
+    SDL_Rect destination{origin.x, origin.y, source.w, source.h};
+    if (SDL_BlitSurface(manifest.sheets[uniqueFrames[i].sheet].pixels->surface,
+                        &source, atlases[placements[i].atlas]->surface,
+                        &destination) != 0)
+      throw std::runtime_error{SDL_GetError()};
+  }
+  auto uniqueIndex{uniqueIndices.begin()};
+  for (auto &animation : manifest.animations)
+    for (auto &frame : animation.frames) {
+      const auto i{*uniqueIndex++};
+      frame.sprite = {{placements[i].origin, frame.sprite.source.width,
+                       frame.sprite.source.height},
+                      placements[i].atlas};
+    }
+  for (std::size_t i{0}; i < atlases.size(); ++i) {
+    const auto path{outputPrefix + '-' + std::to_string(i) + ".png"};
+    if (IMG_SavePNG(atlases[i]->surface, path.c_str()) != 0)
+      throw std::runtime_error{"unable to write " + path};
+  }
+  std::ofstream table{outputPrefix + ".anim", std::ios::binary};
+  writeAnimationTable(table, manifest.animations, atlases.size());
+  if (!table)
+    throw std::runtime_error{"unable to write " + outputPrefix + ".anim"};
+  std::cout << uniqueFrames.size() << " frames in " << atlases.size()
+            << " atlases\n";
+  return EXIT_SUCCESS;
+}
+} // namespace sbash64::game
+
+int main(int argc, char *argv[]) {
+  std::span<char *> arguments{argv,
+                              static_cast<std::span<char *>::size_type>(argc)};
+  if (arguments.size() < 3) {
+    std::cerr << "usage: " << arguments[0]
+              << " <manifest> <output prefix> [atlas size]\n";
+    return EXIT_FAILURE;
+  }
+  try {
+    return sbash64::game::run(arguments[1], arguments[2],
+                              arguments.size() > 3 ? std::stoi(arguments[3])
+                                                   : 512);
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << '\n';
+    return EXIT_FAILURE;
+  }
+}
@@ -0,0 +1,59 @@
+#include <sbash64/game/parallax.hpp>
+
+#include <cstddef>
+#include <ostream>
+#include <stdexcept>
+
+namespace sbash64::game {
+static auto floorDivide(distance_type a, distance_type b) -> distance_type {
+  return a / b - static_cast<distance_type>(a % b != 0 && isNegative(a));
+}
+
+ParallaxLayer::ParallaxLayer(distance_type imageWidth, distance_type height,
+                             distance_type stripWidth, int scrollPercent)
+    : imageWidth{imageWidth}, height{height}, stripWidth{stripWidth},
+      scrollPercent{scrollPercent} {
+  if (imageWidth <= 0 || height <= 0 || stripWidth <= 0)
+    throw std::runtime_error{"empty parallax layer"};
+}
+
+auto ParallaxLayer::cacheWidth() const -> distance_type {
+  return 2 * stripWidth;
+}
+
+auto ParallaxLayer::cacheHeight() const -> distance_type { return height; }
+
+auto ParallaxLayer::scrollOffset(distance_type cameraLeft) const
+    -> distance_type {
+  return floorDivide(cameraLeft * scrollPercent, 100);
+}
+
+auto ParallaxLayer::stripOf(distance_type offset) const -> distance_type {
+  return floorDivide(offset, stripWidth);
+}
+
+auto ParallaxLayer::imageColumn(distance_type x) const -> distance_type {
+  return x - floorDivide(x, imageWidth) * imageWidth;
+}
+
+void dump(std::ostream &stream, const ParallaxStats &stats) {
+  const auto hundredths{stats.screenPixels == 0
+                            ? 0
+                            : 100 * stats.drawnPixels / stats.screenPixels};
+  stream << "background overdraw: " << hundredths / 100 << '.'
+         << (hundredths % 100 < 10 ? "0" : "") << hundredths % 100 << '\n';
+  for (std::size_t i{0}; i < stats.layers.size(); ++i) {
+    const auto &layer{stats.layers[i]};
+    stream << "parallax layer " << i
+           << " recomposites/frames: " << layer.recomposites << '/'
+           << stats.frames << ", composited/drawn pixels: "
+           << layer.compositedPixels << '/' << layer.drawnPixels
+           << ", mean ns: "
+           << (stats.frames == 0
+                   ? 0
+                   : layer.totalNanoseconds /
+                         static_cast<std::int64_t>(stats.frames))
+           << '\n';
+  }
+}
+} // namespace sbash64::game
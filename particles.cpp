@@ -0,0 +1,102 @@
+#include <sbash64/game/particles.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <vector>
+
+namespace sbash64::game {
+constexpr auto subpixelBits{8};
+constexpr distance_type subpixels{1 << subpixelBits};
+
+static auto toSubpixels(RationalDistance distance) -> std::int32_t {
+  return static_cast<std::int32_t>(round(
+      RationalDistance{distance.numerator * subpixels, distance.denominator}));
+}
+
+ParticlePool::ParticlePool(std::size_t capacity)
+    : x(capacity), y(capacity), horizontalVelocity(capacity),
+      verticalVelocity(capacity), ticks(capacity), color(capacity) {}
+
+auto ParticlePool::spawn(Point position, RationalDistance horizontalVelocity,
+                         RationalDistance verticalVelocity, std::int32_t ticks,
+                         std::uint8_t color) -> bool {
+  if (count == x.size()) {
+    ++droppedCount;
+    return false;
+  }
+  x[count] = position.x * subpixels;
+  y[count] = position.y * subpixels;
+  this->horizontalVelocity[count] = toSubpixels(horizontalVelocity);
+  this->verticalVelocity[count] = toSubpixels(verticalVelocity);
+  this->ticks[count] = ticks;
+  this->color[count] = color;
+  ++count;
+  ++spawnedCount;
+  peakCount = std::max(peakCount, count);
+  return true;
+}
+
+void ParticlePool::update(RationalDistance gravity,
+                          std::optional<distance_type> floorTop) {
+  const auto acceleration{toSubpixels(gravity)};
+  auto *const xs{x.data()};
+  auto *const ys{y.data()};
+  auto *const horizontalVelocities{horizontalVelocity.data()};
+  auto *const verticalVelocities{verticalVelocity.data()};
+  auto *const remaining{ticks.data()};
+  for (std::size_t i{0}; i < count; ++i) {
+    verticalVelocities[i] += acceleration;
+    xs[i] += horizontalVelocities[i];
+    ys[i] += verticalVelocities[i];
+    --remaining[i];
+  }
+  if (floorTop) {
+    const auto lowest{(*floorTop - 1) * subpixels};
+    for (std::size_t i{0}; i < count; ++i) {
+      const auto below{ys[i] > lowest};
+      ys[i] = below ? lowest : ys[i];
+      verticalVelocities[i] =
+          below ? -verticalVelocities[i] / 2 : verticalVelocities[i];
+    }
+  }
+  for (std::size_t i{0}; i < count;)
+    if (remaining[i] <= 0) {
+      --count;
+      xs[i] = xs[count];
+      ys[i] = ys[count];
+      horizontalVelocities[i] = horizontalVelocities[count];
+      verticalVelocities[i] = verticalVelocities[count];
+      remaining[i] = remaining[count];
+      color[i] = color[count];
+    } else
+      ++i;
+}
+
+void ParticlePool::collect(
+    Rectangle camera, std::span<std::vector<ScreenRectangle>> byColor) const {
+  for (std::size_t i{0}; i < count; ++i) {
+    const Point pixel{x[i] >> subpixelBits, y[i] >> subpixelBits};
+    if (pixel.x >= leftEdge(camera) && pixel.x <= rightEdge(camera) &&
+        pixel.y >= topEdge(camera) && pixel.y <= bottomEdge(camera))
+      byColor[color[i]].push_back(
+          relativeTo({pixel, 1, 1}, camera.origin));
+  }
+}
+
+auto ParticlePool::live() const -> std::size_t { return count; }
+
+auto ParticlePool::spawned() const -> std::uint64_t { return spawnedCount; }
+
+auto ParticlePool::dropped() const -> std::uint64_t { return droppedCount; }
+
+auto ParticlePool::peak() const -> std::size_t { return peakCount; }
+
+void dump(std::ostream &stream, const ParticlePool &pool) {
+  stream << "particles spawned/dropped: " << pool.spawned() << '/'
+         << pool.dropped() << ", peak live: " << pool.peak() << '\n';
+}
+} // namespace sbash64::game
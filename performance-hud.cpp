@@ -0,0 +1,266 @@
+#include <sbash64/game/performance-hud.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace sbash64::game {
+constexpr screen_distance_type glyphWidth{3};
+constexpr screen_distance_type glyphHeight{5};
+constexpr screen_distance_type padding{2};
+constexpr screen_distance_type lineHeight{glyphHeight + 1};
+constexpr screen_distance_type graphHeight{8 * lineHeight - 1};
+constexpr screen_distance_type textWidth{12 * (glyphWidth + 1)};
+constexpr std::int64_t frameBudgetNanoseconds{16'666'667};
+// The top of the graph, so that frames twice over budget reach it.
+constexpr std::int64_t graphNanoseconds{2 * frameBudgetNanoseconds};
+
+// Rows from the top, with the leftmost pixel in the highest of 3 bits.
+using Glyph = std::array<std::uint8_t, glyphHeight>;
+
+static auto glyph(char c) -> Glyph {
+  switch (c) {
+  case '0':
+    return {0b111, 0b101, 0b101, 0b101, 0b111};
+  case '1':
+    return {0b010, 0b110, 0b010, 0b010, 0b111};
+  case '2':
+    return {0b111, 0b001, 0b111, 0b100, 0b111};
+  case '3':
+    return {0b111, 0b001, 0b111, 0b001, 0b111};
+  case '4':
+    return {0b101, 0b101, 0b111, 0b001, 0b001};
+  case '5':
+    return {0b111, 0b100, 0b111, 0b001, 0b111};
+  case '6':
+    return {0b111, 0b100, 0b111, 0b101, 0b111};
+  case '7':
+    return {0b111, 0b001, 0b001, 0b001, 0b001};
+  case '8':
+    return {0b111, 0b101, 0b111, 0b101, 0b111};
+  case '9':
+    return {0b111, 0b101, 0b111, 0b001, 0b111};
+  case '.':
+    return {0b000, 0b000, 0b000, 0b000, 0b010};
+  case '%':
+    return {0b101, 0b001, 0b010, 0b100, 0b101};
+  case 'A':
+    return {0b010, 0b101, 0b111, 0b101, 0b101};
+  case 'D':
+    return {0b110, 0b101, 0b101, 0b101, 0b110};
+  case 'E':
+    return {0b111, 0b100, 0b110, 0b100, 0b111};
+  case 'F':
+    return {0b111, 0b100, 0b110, 0b100, 0b100};
+  case 'H':
+    return {0b101, 0b101, 0b111, 0b101, 0b101};
+  case 'I':
+    return {0b111, 0b010, 0b010, 0b010, 0b111};
+  case 'M':
+    return {0b101, 0b111, 0b111, 0b101, 0b101};
+  case 'N':
+    return {0b110, 0b101, 0b101, 0b101, 0b101};
+  case 'P':
+    return {0b110, 0b101, 0b110, 0b100, 0b100};
+  case 'R':
+    return {0b110, 0b101, 0b110, 0b101, 0b101};
+  case 'S':
+    return {0b011, 0b100, 0b010, 0b001, 0b110};
+  case 'T':
+    return {0b111, 0b010, 0b010, 0b010, 0b010};
+  case 'U':
+    return {0b101, 0b101, 0b101, 0b101, 0b111};
+  case 'W':
+    return {0b101, 0b101, 0b111, 0b111, 0b101};
+  case '#':
+    return {0b111, 0b111, 0b111, 0b111, 0b111};
+  default:
+    return {};
+  }
+}
+
+namespace {
+// A line of text built without allocating.
+class Line {
+public:
+  void append(std::string_view text) {
+    for (const auto c : text)
+      append(c);
+  }
+
+  void append(char c) {
+    if (size < characters.size())
+      characters[size++] = c;
+  }
+
+  void append(std::int64_t value) {
+    if (value < 0) {
+      append('-');
+      value = -value;
+    }
+    std::array<char, 20> digits{};
+    std::size_t count{0};
+    do {
+      digits[count++] = static_cast<char>('0' + value % 10);
+      value /= 10;
+    } while (value != 0);
+    while (count != 0)
+      append(digits[--count]);
+  }
+
+  // The nanoseconds in milliseconds to two decimal places.
+  void appendMilliseconds(std::int64_t nanoseconds) {
+    const auto hundredths{nanoseconds / 10'000};
+    append(hundredths / 100);
+    append('.');
+    append(static_cast<char>('0' + hundredths / 10 % 10));
+    append(static_cast<char>('0' + hundredths % 10));
+  }
+
+  [[nodiscard]] auto text() const -> std::string_view {
+    return {characters.data(), size};
+  }
+
+private:
+  std::array<char, 12> characters{};
+  std::size_t size{0};
+};
+
+class Painter {
+public:
+  Painter(HudRectangles &rectangles, ScreenPoint origin,
+          screen_distance_type scale)
+      : rectangles{rectangles}, origin{origin}, scale{scale} {}
+
+  void fill(HudColor color, screen_distance_type x, screen_distance_type y,
+            screen_distance_type width, screen_distance_type height) {
+    if (width > 0 && height > 0)
+      rectangles[static_cast<std::size_t>(color)].push_back(
+          {{origin.x + x * scale, origin.y + y * scale},
+           width * scale,
+           height * scale});
+  }
+
+  // Each glyph row's runs of lit pixels are one rectangle. A '#' is a
+  // swatch in the given color rather than text.
+  void write(std::string_view text, screen_distance_type x,
+             screen_distance_type y, HudColor swatch) {
+    for (const auto c : text) {
+      const auto rows{glyph(c)};
+      const auto color{c == '#' ? swatch : HudColor::text};
+      for (screen_distance_type row{0}; row < glyphHeight; ++row) {
+        const auto bits{rows[static_cast<std::size_t>(row)]};
+        const auto lit{[bits](screen_distance_type column) {
+          return (bits >> (glyphWidth - 1 - column) & 1U) != 0;
+        }};
+        screen_distance_type column{0};
+        while (column < glyphWidth) {
+          if (!lit(column)) {
+            ++column;
+            continue;
+          }
+          const auto start{column};
+          while (column < glyphWidth && lit(column))
+            ++column;
+          fill(color, x + start, y + row, column - start, 1);
+        }
+      }
+      x += glyphWidth + 1;
+    }
+  }
+
+private:
+  HudRectangles &rectangles;
+  ScreenPoint origin;
+  screen_distance_type scale;
+};
+} // namespace
+
+static auto barHeight(std::int64_t nanoseconds) -> screen_distance_type {
+  return static_cast<screen_distance_type>(
+      std::clamp(nanoseconds, std::int64_t{0}, graphNanoseconds) *
+      graphHeight / graphNanoseconds);
+}
+
+void PerformanceHud::record(HudFrame frame) {
+  frames[next] = frame;
+  next = (next + 1) % history;
+  recorded = std::min(recorded + 1, history);
+}
+
+void PerformanceHud::layout(const HudCounters &counters, ScreenPoint origin,
+                            screen_distance_type scale,
+                            HudRectangles &rectangles) const {
+  for (auto &byColor : rectangles)
+    byColor.clear();
+  Painter painter{rectangles, origin, scale};
+  constexpr auto graphWidth{static_cast<screen_distance_type>(history)};
+  painter.fill(HudColor::panel, 0, 0,
+               padding + graphWidth + padding + textWidth + padding,
+               padding + graphHeight + padding);
+  constexpr auto graphBottom{padding + graphHeight};
+  painter.fill(HudColor::frame, padding,
+               graphBottom - barHeight(frameBudgetNanoseconds), graphWidth,
+               1);
+  // Oldest on the left, so the newest frame is always at the right edge.
+  for (std::size_t i{0}; i < recorded; ++i) {
+    const auto &frame{frames[(next + history - recorded + i) % history]};
+    const auto x{padding + graphWidth -
+                 static_cast<screen_distance_type>(recorded - i)};
+    auto top{graphBottom};
+    std::int64_t stacked{0};
+    for (const auto &[color, nanoseconds] :
+         {std::pair{HudColor::simulation, frame.simulationNanoseconds},
+          std::pair{HudColor::render, frame.renderNanoseconds},
+          std::pair{HudColor::present, frame.presentNanoseconds}}) {
+      stacked += nanoseconds;
+      const auto stackedTop{graphBottom - barHeight(stacked)};
+      painter.fill(color, x, stackedTop, 1, top - stackedTop);
+      top = stackedTop;
+    }
+    painter.fill(frame.frameNanoseconds > frameBudgetNanoseconds
+                     ? HudColor::overBudget
+                     : HudColor::frame,
+                 x, graphBottom - barHeight(frame.frameNanoseconds), 1, 1);
+  }
+  const auto latest{recorded == 0 ? HudFrame{}
+                                  : frames[(next + history - 1) % history]};
+  const auto textLeft{padding + graphWidth + padding};
+  auto lineTop{padding};
+  const auto writeLine{[&](const Line &line, HudColor swatch) {
+    painter.write(line.text(), textLeft, lineTop, swatch);
+    lineTop += lineHeight;
+  }};
+  for (const auto &[label, nanoseconds, color] :
+       {std::tuple{"# SIM ", latest.simulationNanoseconds,
+                   HudColor::simulation},
+        std::tuple{"# REN ", latest.renderNanoseconds, HudColor::render},
+        std::tuple{"# PRE ", latest.presentNanoseconds, HudColor::present},
+        std::tuple{"# FRM ", latest.frameNanoseconds,
+                   latest.frameNanoseconds > frameBudgetNanoseconds
+                       ? HudColor::overBudget
+                       : HudColor::frame},
+        std::tuple{"  HUD ", counters.hudNanoseconds, HudColor::text}}) {
+    Line line;
+    line.append(label);
+    line.appendMilliseconds(nanoseconds);
+    writeLine(line, color);
+  }
+  for (const auto &[label, value, suffix] :
+       {std::tuple{"  ENT ", static_cast<std::int64_t>(counters.entities), ""},
+        std::tuple{"  DRW ", static_cast<std::int64_t>(counters.drawCalls),
+                   ""},
+        std::tuple{"  AUD ", counters.audioFillPercent, "%"}}) {
+    Line line;
+    line.append(label);
+    line.append(value);
+    line.append(suffix);
+    writeLine(line, HudColor::text);
+  }
+}
+} // namespace sbash64::game
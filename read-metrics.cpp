@@ -0,0 +1,102 @@
+#include <sbash64/game/metrics.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+// Prints the metrics that the game publishes with --metrics=<name>, once or,
+// given an interval in milliseconds, repeatedly with counter rates.
+namespace sbash64::game {
+// The upper edge of the bucket holding the given fraction of samples.
+static auto percentile(const MetricValue &metric, std::uint64_t samples,
+                       double fraction) -> std::int64_t {
+  const auto wanted{static_cast<std::uint64_t>(fraction * samples)};
+  std::uint64_t seen{0};
+  for (std::size_t b{0}; b < histogramBuckets; ++b) {
+    seen += metric.buckets[b];
+    if (seen > wanted)
+      return static_cast<std::int64_t>(b + 1) * metric.bucketWidth;
+  }
+  return static_cast<std::int64_t>(histogramBuckets) * metric.bucketWidth;
+}
+
+static void print(std::span<const MetricValue> metrics,
+                  std::span<const MetricValue> previous,
+                  std::chrono::milliseconds interval) {
+  for (std::size_t i{0}; i < metrics.size(); ++i) {
+    const auto &metric{metrics[i]};
+    std::cout << metric.name.data() << ": ";
+    switch (metric.kind) {
+    case MetricKind::counter:
+      std::cout << metric.value;
+      if (i < previous.size() && interval.count() > 0)
+        std::cout << " ("
+                  << (metric.value - previous[i].value) * 1000 /
+                         interval.count()
+                  << "/s)";
+      break;
+    case MetricKind::gauge:
+      std::cout << metric.value;
+      break;
+    case MetricKind::histogram: {
+      const auto samples{std::accumulate(metric.buckets.begin(),
+                                         metric.buckets.end(),
+                                         std::uint64_t{0})};
+      std::cout << samples << " samples";
+      if (samples != 0)
+        std::cout << ", mean "
+                  << metric.value / static_cast<std::int64_t>(samples)
+                  << ", p50 < " << percentile(metric, samples, 0.5)
+                  << ", p99 < " << percentile(metric, samples, 0.99);
+      break;
+    }
+    }
+    std::cout << '\n';
+  }
+}
+
+static auto run(const std::string &name, std::chrono::milliseconds interval)
+    -> int {
+  SharedMetrics shared{name, SharedMetrics::Access::read};
+  std::array<MetricValue, maximumMetrics> values{};
+  std::array<MetricValue, maximumMetrics> previous{};
+  std::size_t previousCount{0};
+  while (true) {
+    const auto count{read(shared.segment(), values)};
+    print(std::span{values}.first(count),
+          std::span{previous}.first(previousCount), interval);
+    if (interval.count() == 0)
+      return EXIT_SUCCESS;
+    previous = values;
+    previousCount = count;
+    std::this_thread::sleep_for(interval);
+    std::cout << '\n';
+  }
+}
+} // namespace sbash64::game
+
+int main(int argc, char *argv[]) {
+  std::span<char *> arguments{argv,
+                              static_cast<std::span<char *>::size_type>(argc)};
+  if (arguments.size() < 2) {
+    std::cerr << "usage: " << arguments[0]
+              << " <shared memory name> [interval milliseconds]\n";
+    return EXIT_FAILURE;
+  }
+  try {
+    return sbash64::game::run(
+        arguments[1], std::chrono::milliseconds{
+                          arguments.size() > 2 ? std::stoi(arguments[2]) : 0});
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << '\n';
+    return EXIT_FAILURE;
+  }
+}
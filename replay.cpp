@@ -0,0 +1,93 @@
+#include <sbash64/game/replay.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+
+namespace sbash64::game {
+constexpr std::array<char, 4> magic{'S', 'B', 'R', 'P'};
+constexpr std::uint8_t version{1};
+
+template <typename T>
+static void writeLittleEndian(std::ostream &stream, T value) {
+  for (std::size_t i{0}; i < sizeof value; ++i)
+    stream.put(static_cast<char>((value >> (8 * i)) & 0xFFU));
+}
+
+// Returns nullopt when the stream ends before the whole value.
+template <typename T>
+static auto readLittleEndian(std::istream &stream) -> std::optional<T> {
+  std::array<char, sizeof(T)> bytes{};
+  if (!stream.read(bytes.data(), bytes.size()))
+    return std::nullopt;
+  T value{0};
+  for (std::size_t i{0}; i < bytes.size(); ++i)
+    value |= static_cast<T>(static_cast<unsigned char>(bytes[i])) << (8 * i);
+  return value;
+}
+
+template <typename T> static auto readField(std::istream &stream) -> T {
+  if (const auto value{readLittleEndian<T>(stream)})
+    return *value;
+  throw std::runtime_error{"truncated replay"};
+}
+
+ReplayWriter::ReplayWriter(std::ostream &stream) : stream{stream} {
+  stream.write(magic.data(), magic.size());
+  writeLittleEndian(stream, version);
+}
+
+void ReplayWriter::write(const ReplayTick &tick) {
+  if (tick.hashes.fields.size() > std::numeric_limits<std::uint16_t>::max())
+    throw std::runtime_error{"too many state fields to replay"};
+  writeLittleEndian(
+      stream, static_cast<std::uint8_t>(
+                  static_cast<unsigned>(tick.input.left) |
+                  static_cast<unsigned>(tick.input.right) << 1U |
+                  static_cast<unsigned>(tick.input.jump) << 2U));
+  writeLittleEndian(stream,
+                    static_cast<std::uint16_t>(tick.hashes.fields.size()));
+  writeLittleEndian(stream, tick.hashes.combined);
+  for (const auto field : tick.hashes.fields)
+    writeLittleEndian(stream, field);
+}
+
+ReplayReader::ReplayReader(std::istream &stream) : stream{stream} {
+  std::array<char, magic.size()> header{};
+  if (!stream.read(header.data(), header.size()) || header != magic)
+    throw std::runtime_error{"not a replay"};
+  if (readField<std::uint8_t>(stream) != version)
+    throw std::runtime_error{"unsupported replay version"};
+}
+
+auto ReplayReader::read(ReplayTick &tick) -> bool {
+  const auto input{readLittleEndian<std::uint8_t>(stream)};
+  if (!input)
+    return false;
+  const auto fields{readLittleEndian<std::uint16_t>(stream)};
+  const auto combined{readLittleEndian<std::uint64_t>(stream)};
+  if (!fields || !combined) {
+    endedPartway = true;
+    return false;
+  }
+  tick.input = {(*input & 1U) != 0, (*input & 2U) != 0, (*input & 4U) != 0};
+  tick.hashes.fields.resize(*fields);
+  tick.hashes.combined = *combined;
+  for (auto &field : tick.hashes.fields) {
+    const auto value{readLittleEndian<std::uint64_t>(stream)};
+    if (!value) {
+      endedPartway = true;
+      return false;
+    }
+    field = *value;
+  }
+  return true;
+}
+
+auto ReplayReader::truncated() const -> bool { return endedPartway; }
+} // namespace sbash64::game
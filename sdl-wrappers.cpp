@@ -46,6 +46,14 @@ Texture::Texture(SDL_Renderer *renderer, SDL_Surface *surface)
     throwRuntimeError("Unable to create texture!");
 }
 
+Texture::Texture(SDL_Renderer *renderer, int width, int height)
+    : texture{SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888,
+                                SDL_TEXTUREACCESS_TARGET, width, height)} {
+  if (texture == nullptr)
+    throwRuntimeError("Unable to create render target!");
+  SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+}
+
 Texture::~Texture() { SDL_DestroyTexture(texture); }
 
 ImageInit::ImageInit() {
@@ -56,6 +64,13 @@ ImageInit::ImageInit() {
 
 ImageInit::~ImageInit() { IMG_Quit(); }
 
+Surface::Surface(SDL_Surface *surface) : surface{surface} {
+  if (surface == nullptr)
+    throwRuntimeError("Unable to create surface!");
+}
+
+Surface::~Surface() { SDL_FreeSurface(surface); }
+
 ImageSurface::ImageSurface(const std::string &imagePath)
     : surface{IMG_Load(imagePath.c_str())} {
   if (surface == nullptr) {
@@ -21,6 +21,12 @@ File::File(const std::string &path)
     throwSndfileRuntimeError("Not able to open input file");
 }
 
+File::File(const std::string &path, const SF_INFO &writeInfo)
+    : info{writeInfo}, file{sf_open(path.c_str(), SFM_WRITE, &info)} {
+  if (file == nullptr)
+    throwSndfileRuntimeError("Not able to open output file");
+}
+
 File::~File() { sf_close(file); }
 } // namespace sndfile_wrappers
 } // namespace sbash64::game
@@ -0,0 +1,144 @@
+#include <sbash64/game/state-hash.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace sbash64::game {
+constexpr std::uint64_t prime1{0x9E3779B185EBCA87U};
+constexpr std::uint64_t prime2{0xC2B2AE3D27D4EB4FU};
+constexpr std::uint64_t prime3{0x165667B19E3779F9U};
+constexpr std::uint64_t prime4{0x85EBCA77C2B2CA63U};
+constexpr std::uint64_t prime5{0x27D4EB2F165667C5U};
+constexpr std::size_t fieldsPerEntity{4};
+constexpr std::array<const char *, fieldsPerEntity> entityFieldNames{
+    "rectangle", "velocity", "jump state", "direction facing"};
+
+static auto accumulate(std::uint64_t lane, std::uint64_t word)
+    -> std::uint64_t {
+  return std::rotl(lane + word * prime2, 31) * prime1;
+}
+
+static auto merge(std::uint64_t hash, std::uint64_t lane) -> std::uint64_t {
+  return (hash ^ accumulate(0, lane)) * prime1 + prime4;
+}
+
+StateHasher::StateHasher(std::uint64_t seed)
+    : lanes{seed + prime1 + prime2, seed + prime2, seed, seed - prime1},
+      seed{seed} {}
+
+void StateHasher::add(std::int64_t word) {
+  pending[pendingWords++] = static_cast<std::uint64_t>(word);
+  ++words;
+  if (pendingWords == pending.size()) {
+    for (std::size_t i{0}; i < lanes.size(); ++i)
+      lanes[i] = accumulate(lanes[i], pending[i]);
+    pendingWords = 0;
+  }
+}
+
+auto StateHasher::digest() const -> std::uint64_t {
+  auto hash{seed + prime5};
+  if (words >= lanes.size()) {
+    hash = std::rotl(lanes[0], 1) + std::rotl(lanes[1], 7) +
+           std::rotl(lanes[2], 12) + std::rotl(lanes[3], 18);
+    for (const auto lane : lanes)
+      hash = merge(hash, lane);
+  }
+  hash += words * sizeof(std::uint64_t);
+  for (std::size_t i{0}; i < pendingWords; ++i)
+    hash =
+        std::rotl(hash ^ accumulate(0, pending[i]), 27) * prime1 + prime4;
+  hash ^= hash >> 33U;
+  hash *= prime2;
+  hash ^= hash >> 29U;
+  hash *= prime3;
+  hash ^= hash >> 32U;
+  return hash;
+}
+
+template <typename... Words>
+static auto hashWords(Words... words) -> std::uint64_t {
+  StateHasher hasher;
+  (hasher.add(static_cast<std::int64_t>(words)), ...);
+  return hasher.digest();
+}
+
+static auto hash(Rectangle rectangle) -> std::uint64_t {
+  return hashWords(rectangle.origin.x, rectangle.origin.y, rectangle.width,
+                   rectangle.height);
+}
+
+void hashState(GameWorld &world, Rectangle camera, StateHashes &hashes) {
+  hashes.fields.clear();
+  world.eachArchetype([&](auto &archetype) {
+    using A = std::remove_reference_t<decltype(archetype)>;
+    if constexpr (A::template has<Velocity>) {
+      const auto rectangles{archetype.template column<Rectangle>()};
+      const auto velocities{archetype.template column<Velocity>()};
+      for (std::size_t row{0}; row < archetype.size(); ++row) {
+        const auto velocity{velocities[row]};
+        hashes.fields.push_back(hash(rectangles[row]));
+        hashes.fields.push_back(hashWords(velocity.vertical.numerator,
+                                          velocity.vertical.denominator,
+                                          velocity.horizontal));
+        if constexpr (A::template has<JumpState>)
+          hashes.fields.push_back(
+              hashWords(archetype.template column<JumpState>()[row]));
+        else
+          hashes.fields.push_back(hashWords(-1));
+        if constexpr (A::template has<DirectionFacing>)
+          hashes.fields.push_back(
+              hashWords(archetype.template column<DirectionFacing>()[row]));
+        else
+          hashes.fields.push_back(hashWords(-1));
+      }
+    }
+  });
+  hashes.fields.push_back(hash(camera));
+  StateHasher combined;
+  for (const auto field : hashes.fields)
+    combined.add(static_cast<std::int64_t>(field));
+  hashes.combined = combined.digest();
+}
+
+auto stateFieldName(std::size_t field, std::size_t fields) -> std::string {
+  if (field + 1 == fields)
+    return "camera";
+  return "entity " + std::to_string(field / fieldsPerEntity) + ' ' +
+         entityFieldNames[field % fieldsPerEntity];
+}
+
+auto firstDivergentField(const StateHashes &expected,
+                         const StateHashes &actual)
+    -> std::optional<std::size_t> {
+  if (expected.combined == actual.combined &&
+      expected.fields.size() == actual.fields.size())
+    return std::nullopt;
+  const auto [mismatch, _]{std::ranges::mismatch(expected.fields,
+                                                 actual.fields)};
+  return static_cast<std::size_t>(mismatch - expected.fields.begin());
+}
+
+static auto entities(const StateHashes &hashes) -> std::size_t {
+  return hashes.fields.empty() ? 0
+                               : (hashes.fields.size() - 1) / fieldsPerEntity;
+}
+
+auto describeDivergence(const StateHashes &expected,
+                        const StateHashes &actual)
+    -> std::optional<std::string> {
+  if (expected.fields.size() != actual.fields.size())
+    return "entity count, expected " + std::to_string(entities(expected)) +
+           " but have " + std::to_string(entities(actual));
+  if (const auto field{firstDivergentField(expected, actual)})
+    return stateFieldName(*field, expected.fields.size());
+  return std::nullopt;
+}
+} // namespace sbash64::game
@@ -0,0 +1,66 @@
+#include <sbash64/game/thread-pool.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+
+namespace sbash64::game {
+ThreadPool::ThreadPool(std::size_t threads) {
+  for (std::size_t i{1}; i < threads; ++i)
+    workers.emplace_back([this] { work(); });
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard lock{mutex};
+    stopping = true;
+  }
+  started.notify_all();
+  for (auto &worker : workers)
+    worker.join();
+}
+
+void ThreadPool::run(std::size_t tasks,
+                     const std::function<void(std::size_t)> &task) {
+  {
+    std::lock_guard lock{mutex};
+    this->task = &task;
+    this->tasks = tasks;
+    nextTask = 0;
+    busyWorkers = workers.size();
+    ++batch;
+  }
+  started.notify_all();
+  takeTasks();
+  std::unique_lock lock{mutex};
+  finished.wait(lock, [this] { return busyWorkers == 0; });
+  this->task = nullptr;
+}
+
+auto ThreadPool::threads() const -> std::size_t { return workers.size() + 1; }
+
+void ThreadPool::work() {
+  std::uint64_t seen{0};
+  while (true) {
+    {
+      std::unique_lock lock{mutex};
+      started.wait(lock, [&] { return stopping || batch != seen; });
+      if (stopping)
+        return;
+      seen = batch;
+    }
+    takeTasks();
+    {
+      std::lock_guard lock{mutex};
+      --busyWorkers;
+    }
+    finished.notify_one();
+  }
+}
+
+void ThreadPool::takeTasks() {
+  for (auto i{nextTask++}; i < tasks; i = nextTask++)
+    (*task)(i);
+}
+} // namespace sbash64::game
@@ -0,0 +1,116 @@
+#include <sbash64/game/game.hpp>
+#include <sbash64/game/tile-layer.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace sbash64::game {
+constexpr std::size_t columns{10'000};
+constexpr std::size_t rows{64};
+constexpr distance_type tileSize{16};
+constexpr auto objects{2000};
+
+// Resolves each object vertically and then horizontally, returning the
+// microseconds per object and adding where they ended up to checksum.
+template <typename Resolve>
+static auto microsecondsPerObject(const std::vector<MovingObject> &moving,
+                                  Resolve resolve, distance_type &checksum)
+    -> double {
+  const auto start{std::chrono::steady_clock::now()};
+  for (const auto object : moving) {
+    const auto [vertical, horizontal]{resolve(object)};
+    checksum += topEdge(vertical.object.rectangle) +
+                leftEdge(horizontal.rectangle);
+  }
+  return std::chrono::duration<double, std::micro>{
+             std::chrono::steady_clock::now() - start}
+             .count() /
+         static_cast<double>(moving.size());
+}
+
+// Builds a 10k x 64 tile level with a ground four tiles deep, random
+// columns and floating blocks, then resolves 2000 random moves against
+// the tile layer and against the same tiles as one rectangle each.
+static auto run() -> int {
+  std::mt19937_64 engine{33};
+  const auto chance{[&](int outOf) {
+    return std::uniform_int_distribution<int>{0, outOf - 1}(engine) == 0;
+  }};
+  const auto between{[&](distance_type low, distance_type high) {
+    return std::uniform_int_distribution<distance_type>{low, high}(engine);
+  }};
+  TileLayer tiles{Point{0, 0}, tileSize, columns, rows};
+  for (std::size_t column{0}; column < columns; ++column) {
+    for (auto row{rows - 4}; row < rows; ++row)
+      tiles.set(column, row, true);
+    if (chance(8))
+      for (auto row{rows - 4 - static_cast<std::size_t>(between(1, 6))};
+           row < rows - 4; ++row)
+        tiles.set(column, row, true);
+    if (chance(16))
+      tiles.set(column, static_cast<std::size_t>(between(40, 49)), true);
+  }
+  RectangleColumns rectangles;
+  for (std::size_t row{0}; row < rows; ++row)
+    for (std::size_t column{0}; column < columns; ++column)
+      if (tiles.solid(column, row))
+        rectangles.push_back({Point{static_cast<distance_type>(column) *
+                                        tileSize,
+                                    static_cast<distance_type>(row) *
+                                        tileSize},
+                              tileSize, tileSize});
+  constexpr auto levelWidth{static_cast<distance_type>(columns) * tileSize};
+  constexpr auto levelHeight{static_cast<distance_type>(rows) * tileSize};
+  const Rectangle floorRectangle{Point{0, 100 * levelHeight}, 1, 1};
+  const Rectangle levelRectangle{Point{-1, -1}, levelWidth + 2,
+                                 levelHeight + 2};
+  std::vector<MovingObject> moving;
+  for (auto i{0}; i < objects; ++i)
+    moving.push_back(
+        {Rectangle{Point{between(0, levelWidth - 1),
+                         between(0, levelHeight - 1)},
+                   16, 16},
+         Velocity{{between(-20, 20), 4}, between(-4, 4)}});
+  const RectangleColumns none;
+  distance_type tileChecksum{0};
+  const auto tileMicroseconds{microsecondsPerObject(
+      moving,
+      [&](MovingObject object) {
+        return std::pair{
+            handleVerticalCollisions({object, JumpState::released,
+                                      DirectionFacing::right},
+                                     tiles, none, none, floorRectangle),
+            handleHorizontalCollisions(object, tiles, none, none,
+                                       levelRectangle)};
+      },
+      tileChecksum)};
+  distance_type rectangleChecksum{0};
+  const auto rectangleMicroseconds{microsecondsPerObject(
+      moving,
+      [&](MovingObject object) {
+        return std::pair{
+            handleVerticalCollisions({object, JumpState::released,
+                                      DirectionFacing::right},
+                                     rectangles, rectangles, floorRectangle),
+            handleHorizontalCollisions(object, rectangles, rectangles,
+                                       levelRectangle)};
+      },
+      rectangleChecksum)};
+  std::cout << columns << 'x' << rows << " tiles, " << tiles.solidTiles()
+            << " solid\n"
+            << "tile layer: " << tileMicroseconds << " us per object\n"
+            << "rectangles: " << rectangleMicroseconds << " us per object\n";
+  if (tileChecksum != rectangleChecksum) {
+    std::cerr << "tile layer and rectangles disagree\n";
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+} // namespace sbash64::game
+
+int main() { return sbash64::game::run(); }
@@ -0,0 +1,285 @@
+#include <sbash64/game/tile-layer.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace sbash64::game {
+constexpr std::size_t wordBits{64};
+
+static auto wordsFor(std::size_t bits) -> std::size_t {
+  return (bits + wordBits - 1) / wordBits;
+}
+
+static auto floorDivide(distance_type a, distance_type b) -> distance_type {
+  return a / b - static_cast<distance_type>(a % b != 0 && isNegative(a));
+}
+
+static void assign(std::span<std::uint64_t> line, std::size_t bit,
+                   bool value) {
+  const auto mask{std::uint64_t{1} << (bit % wordBits)};
+  if (value)
+    line[bit / wordBits] |= mask;
+  else
+    line[bit / wordBits] &= ~mask;
+}
+
+// Calls visit(first, last) for each run of set bits within [first, last] of
+// the line, in increasing order, until visit returns true.
+template <typename Visit>
+static auto forEachRun(std::span<const std::uint64_t> line, std::size_t first,
+                       std::size_t last, Visit visit) -> bool {
+  const auto bits{line.size() * wordBits};
+  auto bit{first};
+  while (bit <= last) {
+    const auto word{line[bit / wordBits] >> (bit % wordBits)};
+    if (word == 0) {
+      bit = (bit / wordBits + 1) * wordBits;
+      continue;
+    }
+    bit += static_cast<std::size_t>(std::countr_zero(word));
+    if (bit > last)
+      return false;
+    auto end{bit};
+    while (end < bits) {
+      const auto remaining{wordBits - end % wordBits};
+      const auto ones{static_cast<std::size_t>(
+          std::countr_one(line[end / wordBits] >> (end % wordBits)))};
+      end += std::min(ones, remaining);
+      if (ones < remaining)
+        break;
+    }
+    if (visit(bit, std::min(end - 1, last)))
+      return true;
+    bit = end;
+  }
+  return false;
+}
+
+namespace {
+struct Scan {
+  std::span<const std::uint64_t> words;
+  std::size_t wordsPerLine;
+  std::size_t lines;
+  std::size_t bitsPerLine;
+};
+} // namespace
+
+// Visits lines from firstLine to lastLine in steps of step and, in each, the
+// runs of solid tiles between firstBit and lastBit, until visit returns true.
+template <typename Visit>
+static void scanRuns(const Scan &scan, distance_type firstLine,
+                     distance_type lastLine, distance_type step,
+                     distance_type firstBit, distance_type lastBit,
+                     Visit visit) {
+  if (isNegative((lastLine - firstLine) * step))
+    return;
+  const auto lowestLine{
+      std::max(std::min(firstLine, lastLine), distance_type{0})};
+  const auto highestLine{std::min(std::max(firstLine, lastLine),
+                                  static_cast<distance_type>(scan.lines) - 1)};
+  firstBit = std::max(firstBit, distance_type{0});
+  lastBit =
+      std::min(lastBit, static_cast<distance_type>(scan.bitsPerLine) - 1);
+  if (lowestLine > highestLine || firstBit > lastBit)
+    return;
+  for (auto line{step > 0 ? lowestLine : highestLine};
+       line >= lowestLine && line <= highestLine; line += step)
+    if (forEachRun(scan.words.subspan(static_cast<std::size_t>(line) *
+                                          scan.wordsPerLine,
+                                      scan.wordsPerLine),
+                   static_cast<std::size_t>(firstBit),
+                   static_cast<std::size_t>(lastBit),
+                   [&](std::size_t first, std::size_t last) {
+                     return visit(line, static_cast<distance_type>(first),
+                                  static_cast<distance_type>(last));
+                   }))
+      return;
+}
+
+TileLayer::TileLayer(Point origin, distance_type tileSize, std::size_t columns,
+                     std::size_t rows)
+    : rowWords(rows * wordsFor(columns)), columnWords(columns * wordsFor(rows)),
+      origin{origin}, tileSize{tileSize}, columns{columns}, rows{rows},
+      wordsPerRow{wordsFor(columns)}, wordsPerColumn{wordsFor(rows)} {}
+
+void TileLayer::set(std::size_t column, std::size_t row, bool solid) {
+  assign(std::span{rowWords}.subspan(row * wordsPerRow, wordsPerRow), column,
+         solid);
+  assign(std::span{columnWords}.subspan(column * wordsPerColumn,
+                                        wordsPerColumn),
+         row, solid);
+}
+
+auto TileLayer::solid(std::size_t column, std::size_t row) const -> bool {
+  return ((rowWords[row * wordsPerRow + column / wordBits] >>
+           (column % wordBits)) &
+          1U) != 0;
+}
+
+void TileLayer::fill(Rectangle rectangle) {
+  const auto firstColumn{
+      std::max(column(leftEdge(rectangle)), distance_type{0})};
+  const auto lastColumn{std::min(column(rightEdge(rectangle)),
+                                 static_cast<distance_type>(columns) - 1)};
+  const auto firstRow{std::max(row(topEdge(rectangle)), distance_type{0})};
+  const auto lastRow{std::min(row(bottomEdge(rectangle)),
+                              static_cast<distance_type>(rows) - 1)};
+  for (auto r{firstRow}; r <= lastRow; ++r)
+    for (auto c{firstColumn}; c <= lastColumn; ++c)
+      set(static_cast<std::size_t>(c), static_cast<std::size_t>(r), true);
+}
+
+auto TileLayer::solidTiles() const -> std::size_t {
+  std::size_t count{0};
+  for (const auto word : rowWords)
+    count += static_cast<std::size_t>(std::popcount(word));
+  return count;
+}
+
+auto TileLayer::column(distance_type x) const -> distance_type {
+  return floorDivide(x - origin.x, tileSize);
+}
+
+auto TileLayer::row(distance_type y) const -> distance_type {
+  return floorDivide(y - origin.y, tileSize);
+}
+
+auto TileLayer::firstSurface(MovingObject object,
+                             SweepDirection direction) const
+    -> std::optional<Rectangle> {
+  const auto rectangle{object.rectangle};
+  const auto swept{unite(rectangle, applyVelocity(object).rectangle)};
+  const auto vertical{round(object.velocity.vertical)};
+  const auto horizontal{object.velocity.horizontal};
+  std::optional<Rectangle> surface;
+  const auto rowRun{[&](const CollisionDirection &collisionDirection) {
+    return [&, collision = &collisionDirection](distance_type line,
+                                                distance_type first,
+                                                distance_type last) {
+      const Rectangle run{
+          Point{origin.x + first * tileSize, origin.y + line * tileSize},
+          (last - first + 1) * tileSize, tileSize};
+      if (passesThrough(object, run, *collision, VerticalCollision{}))
+        surface = run;
+      return surface.has_value();
+    };
+  }};
+  const auto columnRun{[&](const CollisionDirection &collisionDirection) {
+    return [&, collision = &collisionDirection](distance_type line,
+                                                distance_type first,
+                                                distance_type last) {
+      const Rectangle run{
+          Point{origin.x + line * tileSize, origin.y + first * tileSize},
+          tileSize, (last - first + 1) * tileSize};
+      if (passesThrough(object, run, *collision, HorizontalCollision{}))
+        surface = run;
+      return surface.has_value();
+    };
+  }};
+  const Scan byRow{rowWords, wordsPerRow, rows, columns};
+  const Scan byColumn{columnWords, wordsPerColumn, columns, rows};
+  switch (direction) {
+  case SweepDirection::fromBelow:
+    scanRuns(byRow, row(bottomEdge(rectangle)) + 1,
+             row(bottomEdge(rectangle) + vertical), 1,
+             column(leftEdge(swept)), column(rightEdge(swept)),
+             rowRun(CollisionFromBelow{}));
+    break;
+  case SweepDirection::fromAbove:
+    scanRuns(byRow, row(topEdge(rectangle)) - 1,
+             row(topEdge(rectangle) + vertical), -1, column(leftEdge(swept)),
+             column(rightEdge(swept)), rowRun(CollisionFromAbove{}));
+    break;
+  case SweepDirection::fromRight:
+    scanRuns(byColumn, column(rightEdge(rectangle)) + 1,
+             column(rightEdge(rectangle) + horizontal), 1,
+             row(topEdge(swept)), row(bottomEdge(swept)),
+             columnRun(CollisionFromRight{}));
+    break;
+  case SweepDirection::fromLeft:
+    scanRuns(byColumn, column(leftEdge(rectangle)) - 1,
+             column(leftEdge(rectangle) + horizontal), -1,
+             row(topEdge(swept)), row(bottomEdge(swept)),
+             columnRun(CollisionFromLeft{}));
+    break;
+  }
+  return surface;
+}
+
+// Surfaces in the given direction are reached in increasing order of this.
+static auto approachOrder(Rectangle surface, SweepDirection direction)
+    -> distance_type {
+  switch (direction) {
+  case SweepDirection::fromBelow:
+    return topEdge(surface);
+  case SweepDirection::fromAbove:
+    return -bottomEdge(surface);
+  case SweepDirection::fromRight:
+    return leftEdge(surface);
+  case SweepDirection::fromLeft:
+  default:
+    return -rightEdge(surface);
+  }
+}
+
+auto firstSurface(MovingObject object, const TileLayer &tiles,
+                  RectangleColumnsView candidates, SweepDirection direction)
+    -> std::optional<Rectangle> {
+  auto nearest{tiles.firstSurface(object, direction)};
+  if (const auto hit{earliestHit(object, candidates, direction)}) {
+    const auto candidate{candidates[hit->index]};
+    if (!nearest || approachOrder(candidate, direction) <
+                        approachOrder(*nearest, direction))
+      nearest = candidate;
+  }
+  return nearest;
+}
+
+auto handleVerticalCollisions(
+    PlayerState playerState, const TileLayer &tiles,
+    RectangleColumnsView collisionFromBelowCandidates,
+    RectangleColumnsView collisionFromAboveCandidates,
+    const Rectangle &floorRectangle) -> PlayerState {
+  if (const auto ground{firstSurface(playerState.object, tiles,
+                                    collisionFromBelowCandidates,
+                                    SweepDirection::fromBelow)})
+    return onPlayerHitGround(playerState, topEdge(*ground));
+  if (isNonnegative(distanceFirstExceedsSecondVertically(
+          applyVerticalVelocity(playerState.object), floorRectangle)))
+    return onPlayerHitGround(playerState, topEdge(floorRectangle));
+  if (const auto ceiling{firstSurface(playerState.object, tiles,
+                                     collisionFromAboveCandidates,
+                                     SweepDirection::fromAbove)}) {
+    playerState.object.velocity.vertical = {0, 1};
+    playerState.object.rectangle.origin.y = bottomEdge(*ceiling) + 1;
+  }
+  return playerState;
+}
+
+auto handleHorizontalCollisions(
+    MovingObject object, const TileLayer &tiles,
+    RectangleColumnsView collisionFromRightCandidates,
+    RectangleColumnsView collisionFromLeftCandidates,
+    const Rectangle &levelRectangle) -> MovingObject {
+  if (const auto wall{firstSurface(object, tiles, collisionFromRightCandidates,
+                                   SweepDirection::fromRight)})
+    return collideHorizontally(object,
+                               leftEdge(*wall) - object.rectangle.width);
+  if (isNonnegative(rightEdge(applyHorizontalVelocity(object)) -
+                    rightEdge(levelRectangle)))
+    return collideHorizontally(object, rightEdge(levelRectangle) -
+                                           object.rectangle.width);
+  if (const auto wall{firstSurface(object, tiles, collisionFromLeftCandidates,
+                                   SweepDirection::fromLeft)})
+    return collideHorizontally(object, rightEdge(*wall) + 1);
+  if (isNonnegative(leftEdge(levelRectangle) -
+                    leftEdge(applyHorizontalVelocity(object))))
+    return collideHorizontally(object, leftEdge(levelRectangle) + 1);
+  return object;
+}
+} // namespace sbash64::game
@@ -0,0 +1,89 @@
+#include <sbash64/game/trigger-zones.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace sbash64::game {
+constexpr std::size_t zoneCount{100'000};
+constexpr distance_type levelWidth{1'000'000};
+constexpr distance_type levelHeight{4096};
+constexpr auto queries{100'000};
+constexpr auto scannedQueries{1000};
+
+static auto microseconds(std::chrono::steady_clock::duration duration,
+                         int count) -> double {
+  return std::chrono::duration<double, std::micro>{duration}.count() / count;
+}
+
+// Builds 100k random zones, plus ten spanning the level, and times 16x16
+// queries through the interval tree against scanning every zone.
+static auto run() -> int {
+  std::mt19937_64 engine{48};
+  const auto between{[&](distance_type low, distance_type high) {
+    return std::uniform_int_distribution<distance_type>{low, high}(engine);
+  }};
+  std::vector<TriggerZone> zones;
+  for (std::size_t i{0}; i < zoneCount; ++i)
+    zones.push_back({Rectangle{Point{between(0, levelWidth - 1),
+                                     between(0, levelHeight - 1)},
+                               between(8, 512), between(8, 512)},
+                     TriggerKind::musicCue, 0});
+  for (auto i{0}; i < 10; ++i)
+    zones.push_back({Rectangle{Point{0, i * levelHeight / 10}, levelWidth, 16},
+                     TriggerKind::checkpoint, 0});
+  const auto buildStart{std::chrono::steady_clock::now()};
+  const TriggerZones triggerZones{zones};
+  const auto built{std::chrono::steady_clock::now() - buildStart};
+  std::vector<Rectangle> regions;
+  for (auto i{0}; i < queries; ++i)
+    regions.push_back({Point{between(0, levelWidth - 1),
+                             between(0, levelHeight - 1)},
+                       16, 16});
+  std::vector<std::size_t> found;
+  std::uint64_t hits{0};
+  const auto queryStart{std::chrono::steady_clock::now()};
+  for (const auto region : regions) {
+    triggerZones.overlapping(region, found);
+    hits += found.size();
+  }
+  const auto queried{std::chrono::steady_clock::now() - queryStart};
+  std::uint64_t scannedHits{0};
+  const auto scanStart{std::chrono::steady_clock::now()};
+  for (auto i{0}; i < scannedQueries; ++i)
+    for (const auto &zone : zones)
+      if (overlaps(zone.region, regions[static_cast<std::size_t>(i)]))
+        ++scannedHits;
+  const auto scanned{std::chrono::steady_clock::now() - scanStart};
+  TriggerOccupancy occupancy;
+  std::vector<TriggerEvent> events;
+  TriggerStats stats{};
+  const auto updateStart{std::chrono::steady_clock::now()};
+  for (auto i{0}; i < queries; ++i) {
+    events.clear();
+    updateOccupancy(triggerZones, occupancy,
+                    {Point{i * 4 % levelWidth, levelHeight / 2}, 16, 16},
+                    events, stats);
+  }
+  const auto updated{std::chrono::steady_clock::now() - updateStart};
+  std::cout << triggerZones.size() << " zones built in "
+            << std::chrono::duration<double, std::milli>{built}.count()
+            << " ms\n"
+            << "query: " << microseconds(queried, queries) << " us, "
+            << static_cast<double>(hits) / queries << " zones each\n"
+            << "linear scan: " << microseconds(scanned, scannedQueries)
+            << " us, "
+            << static_cast<double>(scannedHits) / scannedQueries
+            << " zones each\n"
+            << "occupancy update: " << microseconds(updated, queries)
+            << " us, " << stats.entered << " entered, " << stats.exited
+            << " exited\n";
+  return EXIT_SUCCESS;
+}
+} // namespace sbash64::game
+
+int main() { return sbash64::game::run(); }
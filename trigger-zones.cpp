@@ -0,0 +1,148 @@
+#include <sbash64/game/trigger-zones.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+namespace sbash64::game {
+constexpr auto noNode{std::numeric_limits<std::size_t>::max()};
+
+TriggerZones::TriggerZones(std::vector<TriggerZone> zones)
+    : zones{std::move(zones)} {
+  std::vector<Entry> entries;
+  entries.reserve(this->zones.size());
+  for (std::size_t i{0}; i < this->zones.size(); ++i) {
+    const auto region{this->zones[i].region};
+    entries.push_back({leftEdge(region), rightEdge(region), topEdge(region),
+                       bottomEdge(region), i});
+  }
+  root = build(entries);
+}
+
+// The center is the median of the zones' midpoints, so each child gets at
+// most half of the zones and the median zone itself spans the center.
+auto TriggerZones::build(std::vector<Entry> &entries) -> std::size_t {
+  if (entries.empty())
+    return noNode;
+  const auto midpoint{[](const Entry &entry) {
+    return entry.left + (entry.right - entry.left) / 2;
+  }};
+  const auto median{entries.begin() +
+                    static_cast<std::ptrdiff_t>(entries.size() / 2)};
+  std::nth_element(entries.begin(), median, entries.end(),
+                   [&](const Entry &a, const Entry &b) {
+                     return midpoint(a) < midpoint(b);
+                   });
+  const auto center{midpoint(*median)};
+  std::vector<Entry> leftOfCenter;
+  std::vector<Entry> rightOfCenter;
+  const auto first{byLeft.size()};
+  for (const auto &entry : entries)
+    if (entry.right < center)
+      leftOfCenter.push_back(entry);
+    else if (entry.left > center)
+      rightOfCenter.push_back(entry);
+    else {
+      byLeft.push_back(entry);
+      byRight.push_back(entry);
+    }
+  std::sort(byLeft.begin() + static_cast<std::ptrdiff_t>(first), byLeft.end(),
+            [](const Entry &a, const Entry &b) { return a.left < b.left; });
+  std::sort(byRight.begin() + static_cast<std::ptrdiff_t>(first),
+            byRight.end(),
+            [](const Entry &a, const Entry &b) { return a.right > b.right; });
+  const auto node{nodes.size()};
+  nodes.push_back({center, first, byLeft.size() - first, noNode, noNode});
+  entries.clear();
+  entries.shrink_to_fit();
+  const auto left{build(leftOfCenter)};
+  const auto right{build(rightOfCenter)};
+  nodes[node].left = left;
+  nodes[node].right = right;
+  return node;
+}
+
+static auto overlapsVertically(distance_type top, distance_type bottom,
+                               Rectangle rectangle) -> bool {
+  return top <= bottomEdge(rectangle) && topEdge(rectangle) <= bottom;
+}
+
+void TriggerZones::query(std::size_t node, Rectangle rectangle,
+                         std::vector<std::size_t> &found) const {
+  const auto left{leftEdge(rectangle)};
+  const auto right{rightEdge(rectangle)};
+  while (node != noNode) {
+    const auto &current{nodes[node]};
+    const auto first{static_cast<std::ptrdiff_t>(current.first)};
+    const auto last{first + static_cast<std::ptrdiff_t>(current.count)};
+    if (right < current.center) {
+      for (auto entry{byLeft.begin() + first};
+           entry != byLeft.begin() + last && entry->left <= right; ++entry)
+        if (overlapsVertically(entry->top, entry->bottom, rectangle))
+          found.push_back(entry->zone);
+      node = current.left;
+    } else if (left > current.center) {
+      for (auto entry{byRight.begin() + first};
+           entry != byRight.begin() + last && entry->right >= left; ++entry)
+        if (overlapsVertically(entry->top, entry->bottom, rectangle))
+          found.push_back(entry->zone);
+      node = current.right;
+    } else {
+      for (auto entry{byLeft.begin() + first}; entry != byLeft.begin() + last;
+           ++entry)
+        if (overlapsVertically(entry->top, entry->bottom, rectangle))
+          found.push_back(entry->zone);
+      query(current.left, rectangle, found);
+      node = current.right;
+    }
+  }
+}
+
+void TriggerZones::overlapping(Rectangle rectangle,
+                               std::vector<std::size_t> &found) const {
+  found.clear();
+  query(root, rectangle, found);
+}
+
+auto TriggerZones::zone(std::size_t i) const -> const TriggerZone & {
+  return zones[i];
+}
+
+auto TriggerZones::size() const -> std::size_t { return zones.size(); }
+
+void updateOccupancy(const TriggerZones &zones, TriggerOccupancy &occupancy,
+                     Rectangle rectangle, std::vector<TriggerEvent> &events,
+                     TriggerStats &stats) {
+  ++stats.queries;
+  zones.overlapping(rectangle, occupancy.overlapping);
+  std::sort(occupancy.overlapping.begin(), occupancy.overlapping.end());
+  auto now{occupancy.overlapping.begin()};
+  const auto nowEnd{occupancy.overlapping.end()};
+  for (const auto zone : occupancy.inside) {
+    now = std::lower_bound(now, nowEnd, zone);
+    if (now == nowEnd || *now != zone) {
+      events.push_back({zone, false});
+      ++stats.exited;
+    }
+  }
+  auto before{occupancy.inside.begin()};
+  const auto beforeEnd{occupancy.inside.end()};
+  for (const auto zone : occupancy.overlapping) {
+    before = std::lower_bound(before, beforeEnd, zone);
+    if (before == beforeEnd || *before != zone) {
+      events.push_back({zone, true});
+      ++stats.entered;
+    }
+  }
+  std::swap(occupancy.inside, occupancy.overlapping);
+}
+
+void dump(std::ostream &stream, const TriggerStats &stats) {
+  stream << "trigger zone queries: " << stats.queries
+         << ", entered/exited: " << stats.entered << '/' << stats.exited
+         << '\n';
+}
+} // namespace sbash64::game